@@ -68,11 +68,11 @@ public:
    //
 
    // Subscript
-   T& operator [] (size_t index)       
+   constexpr T& operator [] (size_t index)       
    { 
       return __elems_[index];
    }
-   const T& operator [] (size_t index) const 
+   constexpr const T& operator [] (size_t index) const 
    { 
       return __elems_[index];
    }
@@ -120,11 +120,11 @@ public:
    //
 
    // number of elements in the array
-   size_t size()  const 
+   constexpr size_t size()  const 
    { 
       return N;           
    }
-   bool empty() const 
+   constexpr bool empty() const 
    { 
       return N == 0;
    }
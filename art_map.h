@@ -0,0 +1,1384 @@
+/***********************************************************************
+ * Header:
+ *    ART MAP
+ * Summary:
+ *    An ordered map on an adaptive radix tree: lookups cost the
+ *    length of the key, not the log of the number of keys
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        art_key             : How a key is read one byte at a time
+ *        art_map             : A map on an adaptive radix tree
+ *        art_map::iterator   : An in-order iterator through an art_map
+ * Author
+ *    Tyler and Braeden
+ ************************************************************************/
+
+#pragma once
+
+#include "pair.h"        // for pair
+#include <cstdint>       // for uint8_t and uint16_t
+#include <stdexcept>     // for std::out_of_range
+#include <string>        // for std::string
+#include <type_traits>   // for std::is_integral and std::make_unsigned
+#if defined(__SSE2__)
+#include <emmintrin.h>   // for the Node16 search
+#endif
+
+class TestArtMap;         // forward declaration for unit tests
+
+namespace custom
+{
+
+/************************************************
+ * ART KEY
+ * A key as a string of bytes whose order is the key's
+ * order. Strings are their own bytes. Integers are
+ * written high byte first, with the sign bit flipped
+ * so negative numbers come before positive ones.
+ * Specialize for other key types.
+ ************************************************/
+template <typename K, typename Enable = void>
+struct art_key;
+
+template <>
+struct art_key <std::string>
+{
+   static size_t size(const std::string& k)          { return k.size();     }
+   static uint8_t at(const std::string& k, size_t i) { return (uint8_t)k[i]; }
+};
+
+template <typename K>
+struct art_key <K, typename std::enable_if<std::is_integral<K>::value>::type>
+{
+   static size_t size(const K&)   { return sizeof(K); }
+   static uint8_t at(const K& k, size_t i)
+   {
+      using U = typename std::make_unsigned<K>::type;
+      U u = (U)k;
+      if (std::is_signed<K>::value)
+         u ^= (U)((U)1 << (sizeof(K) * 8 - 1));
+      return (uint8_t)(u >> (8 * (sizeof(K) - 1 - i)));
+   }
+};
+
+/************************************************
+ * ART MAP
+ * A radix tree that branches on one byte of the key
+ * per level, with four node sizes so a sparse level
+ * costs little and a dense one is a direct index:
+ *    Node4, Node16 : sorted bytes beside child pointers
+ *    Node48        : a 256-byte index into 48 children
+ *    Node256       : a child pointer for every byte
+ * Nodes grow and shrink between the sizes as children
+ * come and go. A run of single-child levels is folded
+ * into the prefix of the node below it (path
+ * compression), and a key alone in its subtree is
+ * just a leaf, however deep it would go (lazy
+ * expansion). A key that ends where others go on is
+ * held as the value of the inner node it ends at.
+ ************************************************/
+template <typename K, typename V>
+class art_map
+{
+   friend class ::TestArtMap;   // give unit tests access to the privates
+public:
+   using Pairs = custom::pair<K, V>;
+
+   //
+   // Construct
+   //
+   art_map() : root(nullptr), numElements(0)
+   {
+   }
+   art_map(const art_map& rhs) : root(clone(rhs.root)), numElements(rhs.numElements)
+   {
+   }
+   art_map(art_map&& rhs) : root(rhs.root), numElements(rhs.numElements)
+   {
+      rhs.root = nullptr;
+      rhs.numElements = 0;
+   }
+   template <class Iterator>
+   art_map(Iterator first, Iterator last) : art_map()
+   {
+      insert(first, last);
+   }
+   art_map(const std::initializer_list <Pairs>& il) : art_map()
+   {
+      insert(il);
+   }
+   ~art_map()
+   {
+      clear();
+   }
+
+   //
+   // Assign
+   //
+   art_map& operator = (const art_map& rhs)
+   {
+      if (this != &rhs)
+      {
+         clear();
+         root = clone(rhs.root);
+         numElements = rhs.numElements;
+      }
+      return *this;
+   }
+   art_map& operator = (art_map&& rhs)
+   {
+      clear();
+      swap(rhs);
+      return *this;
+   }
+   art_map& operator = (const std::initializer_list <Pairs>& il)
+   {
+      clear();
+      insert(il);
+      return *this;
+   }
+   void swap(art_map& rhs)
+   {
+      std::swap(root, rhs.root);
+      std::swap(numElements, rhs.numElements);
+   }
+
+   //
+   // Iterator
+   //
+   class iterator;
+   iterator begin() const
+   {
+      return iterator(this, root ? minimum(root) : nullptr);
+   }
+   iterator end() const
+   {
+      return iterator(this, nullptr);
+   }
+
+   //
+   // Access
+   //
+   V& operator [] (const K& k);
+   V& at(const K& k)
+   {
+      Leaf* pLeaf = search(k);
+      if (pLeaf == nullptr)
+         throw std::out_of_range(std::string("invalid art_map<K, T> key"));
+      return pLeaf->data.second;
+   }
+   const V& at(const K& k) const
+   {
+      Leaf* pLeaf = search(k);
+      if (pLeaf == nullptr)
+         throw std::out_of_range(std::string("invalid art_map<K, T> key"));
+      return pLeaf->data.second;
+   }
+   iterator find(const K& k) const
+   {
+      return iterator(this, search(k));
+   }
+   iterator lower_bound(const K& k) const
+   {
+      return iterator(this, seekAbove(root, 0, k, false));
+   }
+   size_t count(const K& k) const
+   {
+      return search(k) ? 1 : 0;
+   }
+   template <class Function>
+   void for_each_prefix(const K& prefix, Function f) const;
+
+   //
+   // Insert
+   //
+   custom::pair<iterator, bool> insert(const Pairs& rhs);
+   template <class Iterator>
+   void insert(Iterator first, Iterator last)
+   {
+      for (; first != last; ++first)
+         insert(*first);
+   }
+   void insert(const std::initializer_list <Pairs>& il)
+   {
+      for (const Pairs& element : il)
+         insert(element);
+   }
+
+   //
+   // Remove
+   //
+   void clear() noexcept
+   {
+      destroy(root);
+      root = nullptr;
+      numElements = 0;
+   }
+   size_t erase(const K& k)
+   {
+      if (!eraseFrom(root, k, 0))
+         return 0;
+      numElements--;
+      return 1;
+   }
+   iterator erase(iterator it)
+   {
+      iterator next = it;
+      ++next;
+      erase(it.pLeaf->data.first);
+      return next;
+   }
+
+   //
+   // Status
+   //
+   bool empty() const noexcept
+   {
+      return numElements == 0;
+   }
+   size_t size() const noexcept
+   {
+      return numElements;
+   }
+
+private:
+   using Key = art_key<K>;
+
+   enum : uint8_t { LEAF, NODE4, NODE16, NODE48, NODE256 };
+
+   // Every node starts with its type
+   struct Header
+   {
+      Header(uint8_t type) : type(type) { }
+      uint8_t type;
+   };
+
+   // One key and its value
+   struct Leaf : Header
+   {
+      Leaf(const Pairs& data) : Header(LEAF), data(data) { }
+      Pairs data;
+   };
+
+   // What all the branching nodes have
+   struct Inner : Header
+   {
+      Inner(uint8_t type) : Header(type), numChildren(0), pValue(nullptr) { }
+      uint16_t numChildren;
+      std::string prefix;   // bytes every key below shares, skipped over
+      Leaf* pValue;         // the key that ends right after the prefix, if any
+   };
+
+   // Children in byte order
+   struct Node4 : Inner
+   {
+      Node4() : Inner(NODE4) { }
+      uint8_t keys[4];
+      Header* children[4];
+   };
+   struct Node16 : Inner
+   {
+      Node16() : Inner(NODE16) { }
+      uint8_t keys[16];
+      Header* children[16];
+   };
+
+   // index[b] is one more than the slot of the child for b, or 0
+   struct Node48 : Inner
+   {
+      Node48() : Inner(NODE48)
+      {
+         for (int i = 0; i < 256; i++) index[i] = 0;
+         for (int i = 0; i < 48; i++)  children[i] = nullptr;
+      }
+      uint8_t index[256];
+      Header* children[48];
+   };
+   struct Node256 : Inner
+   {
+      Node256() : Inner(NODE256)
+      {
+         for (int i = 0; i < 256; i++) children[i] = nullptr;
+      }
+      Header* children[256];
+   };
+
+   //
+   // Keys
+   //
+   static bool sameKey(const K& lhs, const K& rhs)
+   {
+      size_t n = Key::size(lhs);
+      if (n != Key::size(rhs))
+         return false;
+      for (size_t i = 0; i < n; i++)
+         if (Key::at(lhs, i) != Key::at(rhs, i))
+            return false;
+      return true;
+   }
+   static int compareKeys(const K& lhs, const K& rhs);
+
+   //
+   // Children
+   //
+   static size_t lowerBound16(const Node16* pNode, uint8_t b);
+   static Header** findChild(Inner* pNode, uint8_t b);
+   static Header* childFrom(const Inner* pNode, int b);
+   static Header* childBefore(const Inner* pNode, int b);
+   static void addChild(Header*& ref, uint8_t b, Header* pChild);
+   static void removeChild(Inner* pNode, uint8_t b);
+   static void shrink(Header*& ref);
+
+   //
+   // Walks
+   //
+   Leaf* search(const K& k) const;
+   static Leaf* minimum(Header* pNode);
+   static Leaf* maximum(Header* pNode);
+   static Leaf* seekAbove(Header* pNode, size_t depth, const K& k, bool strict);
+   static Leaf* seekBelow(Header* pNode, size_t depth, const K& k);
+   template <class Function>
+   static void walk(const Header* pNode, Function& f);
+
+   bool insertAt(Header*& ref, const Pairs& rhs, size_t depth, Leaf*& pLeaf);
+   bool eraseFrom(Header*& ref, const K& k, size_t depth);
+
+   static Header* clone(const Header* pNode);
+   static void destroy(Header* pNode);
+
+   Header* root;          // null when empty
+   size_t numElements;    // number of keys
+};
+
+/**************************************************
+ * ART MAP ITERATOR
+ * A leaf. Moving on looks up the next key from the
+ * root, which costs the key's length, so it needs no
+ * parent pointers or stack.
+ *************************************************/
+template <typename K, typename V>
+class art_map <K, V> :: iterator
+{
+   friend class ::TestArtMap;   // give unit tests access to the privates
+   friend class art_map;
+public:
+   //
+   // Construct
+   //
+   iterator() : pMap(nullptr), pLeaf(nullptr)
+   {
+   }
+   iterator(const iterator& rhs) : pMap(rhs.pMap), pLeaf(rhs.pLeaf)
+   {
+   }
+
+   //
+   // Assign
+   //
+   iterator& operator = (const iterator& rhs)
+   {
+      pMap = rhs.pMap;
+      pLeaf = rhs.pLeaf;
+      return *this;
+   }
+
+   //
+   // Compare
+   //
+   bool operator == (const iterator& rhs) const
+   {
+      return pLeaf == rhs.pLeaf;
+   }
+   bool operator != (const iterator& rhs) const
+   {
+      return pLeaf != rhs.pLeaf;
+   }
+
+   //
+   // Access
+   //
+   const Pairs& operator * () const
+   {
+      return pLeaf->data;
+   }
+
+   //
+   // Increment
+   //
+   iterator& operator ++ ()
+   {
+      pLeaf = seekAbove(pMap->root, 0, pLeaf->data.first, true);
+      return *this;
+   }
+   iterator operator ++ (int postfix)
+   {
+      iterator old(*this);
+      ++*this;
+      return old;
+   }
+   iterator& operator -- ()
+   {
+      if (pLeaf == nullptr)
+         pLeaf = pMap->root ? maximum(pMap->root) : nullptr;
+      else
+         pLeaf = seekBelow(pMap->root, 0, pLeaf->data.first);
+      return *this;
+   }
+   iterator operator -- (int postfix)
+   {
+      iterator old(*this);
+      --*this;
+      return old;
+   }
+
+private:
+   iterator(const art_map* pMap, Leaf* pLeaf) : pMap(pMap), pLeaf(pLeaf)
+   {
+   }
+
+   const art_map* pMap;
+   Leaf* pLeaf;           // null at the end
+};
+
+/*****************************************************
+ * ART MAP :: SUBSCRIPT
+ * The value for k, put in with V() if it is new
+ ****************************************************/
+template <typename K, typename V>
+V& art_map <K, V> :: operator [] (const K& k)
+{
+   Leaf* pLeaf = search(k);
+   if (pLeaf)
+      return pLeaf->data.second;
+   return insert(Pairs(k, V())).first.pLeaf->data.second;
+}
+
+/*****************************************************
+ * ART MAP :: INSERT
+ ****************************************************/
+template <typename K, typename V>
+custom::pair<typename art_map <K, V> :: iterator, bool>
+art_map <K, V> :: insert(const Pairs& rhs)
+{
+   Leaf* pLeaf = nullptr;
+   bool inserted = insertAt(root, rhs, 0, pLeaf);
+   if (inserted)
+      numElements++;
+   return custom::pair<iterator, bool>(iterator(this, pLeaf), inserted);
+}
+
+/*****************************************************
+ * ART MAP :: FOR EACH PREFIX
+ * Call f on every pair whose key starts with prefix,
+ * in order. Walk down to the subtree that holds them
+ * all, then visit the whole of it.
+ ****************************************************/
+template <typename K, typename V>
+template <class Function>
+void art_map <K, V> :: for_each_prefix(const K& prefix, Function f) const
+{
+   size_t length = Key::size(prefix);
+   size_t depth = 0;
+   Header* pNode = root;
+   while (pNode)
+   {
+      if (pNode->type == LEAF)
+      {
+         const K& k = static_cast<Leaf*>(pNode)->data.first;
+         if (Key::size(k) < length)
+            return;
+         for (size_t i = depth; i < length; i++)
+            if (Key::at(k, i) != Key::at(prefix, i))
+               return;
+         walk(pNode, f);
+         return;
+      }
+
+      Inner* pInner = static_cast<Inner*>(pNode);
+      for (size_t i = 0; i < pInner->prefix.size(); i++, depth++)
+      {
+         if (depth == length)
+            break;
+         if ((uint8_t)pInner->prefix[i] != Key::at(prefix, depth))
+            return;
+      }
+      if (depth == length)
+      {
+         walk(pNode, f);
+         return;
+      }
+      Header** ppChild = findChild(pInner, Key::at(prefix, depth));
+      pNode = ppChild ? *ppChild : nullptr;
+      depth++;
+   }
+}
+
+/*****************************************************
+ * ART MAP :: COMPARE KEYS
+ * Less than zero, zero or more than zero, byte by byte
+ ****************************************************/
+template <typename K, typename V>
+int art_map <K, V> :: compareKeys(const K& lhs, const K& rhs)
+{
+   size_t nLhs = Key::size(lhs);
+   size_t nRhs = Key::size(rhs);
+   for (size_t i = 0; i < nLhs && i < nRhs; i++)
+   {
+      uint8_t a = Key::at(lhs, i);
+      uint8_t b = Key::at(rhs, i);
+      if (a != b)
+         return a < b ? -1 : 1;
+   }
+   return nLhs == nRhs ? 0 : (nLhs < nRhs ? -1 : 1);
+}
+
+/*****************************************************
+ * ART MAP :: LOWER BOUND 16
+ * How many of a Node16's bytes are less than b. With
+ * SSE2 that is one compare of all sixteen at once;
+ * the bytes are unsigned, so flip the top bit to use
+ * the signed compare.
+ ****************************************************/
+template <typename K, typename V>
+size_t art_map <K, V> :: lowerBound16(const Node16* pNode, uint8_t b)
+{
+#if defined(__SSE2__)
+   __m128i flip = _mm_set1_epi8((char)0x80);
+   __m128i keys = _mm_xor_si128(_mm_loadu_si128((const __m128i*)pNode->keys), flip);
+   __m128i key  = _mm_xor_si128(_mm_set1_epi8((char)b), flip);
+   unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmplt_epi8(keys, key));
+   mask &= (1u << pNode->numChildren) - 1;
+   return (size_t)__builtin_popcount(mask);
+#else
+   size_t i = 0;
+   while (i < pNode->numChildren && pNode->keys[i] < b)
+      i++;
+   return i;
+#endif
+}
+
+/*****************************************************
+ * ART MAP :: FIND CHILD
+ * The slot holding the child for byte b, or null
+ ****************************************************/
+template <typename K, typename V>
+typename art_map <K, V> :: Header**
+art_map <K, V> :: findChild(Inner* pNode, uint8_t b)
+{
+   switch (pNode->type)
+   {
+      case NODE4:
+      {
+         Node4* p = static_cast<Node4*>(pNode);
+         for (int i = 0; i < p->numChildren; i++)
+            if (p->keys[i] == b)
+               return &p->children[i];
+         return nullptr;
+      }
+      case NODE16:
+      {
+         Node16* p = static_cast<Node16*>(pNode);
+         size_t i = lowerBound16(p, b);
+         return (i < p->numChildren && p->keys[i] == b) ? &p->children[i] : nullptr;
+      }
+      case NODE48:
+      {
+         Node48* p = static_cast<Node48*>(pNode);
+         return p->index[b] ? &p->children[p->index[b] - 1] : nullptr;
+      }
+      default:
+      {
+         Node256* p = static_cast<Node256*>(pNode);
+         return p->children[b] ? &p->children[b] : nullptr;
+      }
+   }
+}
+
+/*****************************************************
+ * ART MAP :: CHILD FROM
+ * The child with the smallest byte at or above b,
+ * or null. b may be 256, meaning none.
+ ****************************************************/
+template <typename K, typename V>
+typename art_map <K, V> :: Header*
+art_map <K, V> :: childFrom(const Inner* pNode, int b)
+{
+   switch (pNode->type)
+   {
+      case NODE4:
+      {
+         const Node4* p = static_cast<const Node4*>(pNode);
+         for (int i = 0; i < p->numChildren; i++)
+            if (p->keys[i] >= b)
+               return p->children[i];
+         return nullptr;
+      }
+      case NODE16:
+      {
+         const Node16* p = static_cast<const Node16*>(pNode);
+         if (b > 255)
+            return nullptr;
+         size_t i = lowerBound16(p, (uint8_t)b);
+         return i < p->numChildren ? p->children[i] : nullptr;
+      }
+      case NODE48:
+      {
+         const Node48* p = static_cast<const Node48*>(pNode);
+         for (; b < 256; b++)
+            if (p->index[b])
+               return p->children[p->index[b] - 1];
+         return nullptr;
+      }
+      default:
+      {
+         const Node256* p = static_cast<const Node256*>(pNode);
+         for (; b < 256; b++)
+            if (p->children[b])
+               return p->children[b];
+         return nullptr;
+      }
+   }
+}
+
+/*****************************************************
+ * ART MAP :: CHILD BEFORE
+ * The child with the largest byte below b, or null.
+ * b may be 256, meaning the last child.
+ ****************************************************/
+template <typename K, typename V>
+typename art_map <K, V> :: Header*
+art_map <K, V> :: childBefore(const Inner* pNode, int b)
+{
+   switch (pNode->type)
+   {
+      case NODE4:
+      {
+         const Node4* p = static_cast<const Node4*>(pNode);
+         for (int i = p->numChildren - 1; i >= 0; i--)
+            if (p->keys[i] < b)
+               return p->children[i];
+         return nullptr;
+      }
+      case NODE16:
+      {
+         const Node16* p = static_cast<const Node16*>(pNode);
+         size_t i = b > 255 ? p->numChildren : lowerBound16(p, (uint8_t)b);
+         return i > 0 ? p->children[i - 1] : nullptr;
+      }
+      case NODE48:
+      {
+         const Node48* p = static_cast<const Node48*>(pNode);
+         for (b--; b >= 0; b--)
+            if (p->index[b])
+               return p->children[p->index[b] - 1];
+         return nullptr;
+      }
+      default:
+      {
+         const Node256* p = static_cast<const Node256*>(pNode);
+         for (b--; b >= 0; b--)
+            if (p->children[b])
+               return p->children[b];
+         return nullptr;
+      }
+   }
+}
+
+/*****************************************************
+ * ART MAP :: ADD CHILD
+ * Put pChild under byte b, moving the node up to the
+ * next size first if it is full. ref is the pointer
+ * to the node, which changes if it grows.
+ ****************************************************/
+template <typename K, typename V>
+void art_map <K, V> :: addChild(Header*& ref, uint8_t b, Header* pChild)
+{
+   switch (ref->type)
+   {
+      case NODE4:
+      {
+         Node4* p = static_cast<Node4*>(ref);
+         if (p->numChildren < 4)
+         {
+            int i = p->numChildren;
+            for (; i > 0 && p->keys[i - 1] > b; i--)
+            {
+               p->keys[i] = p->keys[i - 1];
+               p->children[i] = p->children[i - 1];
+            }
+            p->keys[i] = b;
+            p->children[i] = pChild;
+            p->numChildren++;
+            return;
+         }
+         Node16* pBigger = new Node16;
+         pBigger->prefix = std::move(p->prefix);
+         pBigger->pValue = p->pValue;
+         pBigger->numChildren = 4;
+         for (int i = 0; i < 4; i++)
+         {
+            pBigger->keys[i] = p->keys[i];
+            pBigger->children[i] = p->children[i];
+         }
+         delete p;
+         ref = pBigger;
+         break;
+      }
+      case NODE16:
+      {
+         Node16* p = static_cast<Node16*>(ref);
+         if (p->numChildren < 16)
+         {
+            size_t i = lowerBound16(p, b);
+            for (size_t j = p->numChildren; j > i; j--)
+            {
+               p->keys[j] = p->keys[j - 1];
+               p->children[j] = p->children[j - 1];
+            }
+            p->keys[i] = b;
+            p->children[i] = pChild;
+            p->numChildren++;
+            return;
+         }
+         Node48* pBigger = new Node48;
+         pBigger->prefix = std::move(p->prefix);
+         pBigger->pValue = p->pValue;
+         pBigger->numChildren = 16;
+         for (int i = 0; i < 16; i++)
+         {
+            pBigger->index[p->keys[i]] = (uint8_t)(i + 1);
+            pBigger->children[i] = p->children[i];
+         }
+         delete p;
+         ref = pBigger;
+         break;
+      }
+      case NODE48:
+      {
+         Node48* p = static_cast<Node48*>(ref);
+         if (p->numChildren < 48)
+         {
+            int slot = 0;
+            while (p->children[slot])
+               slot++;
+            p->children[slot] = pChild;
+            p->index[b] = (uint8_t)(slot + 1);
+            p->numChildren++;
+            return;
+         }
+         Node256* pBigger = new Node256;
+         pBigger->prefix = std::move(p->prefix);
+         pBigger->pValue = p->pValue;
+         pBigger->numChildren = 48;
+         for (int i = 0; i < 256; i++)
+            if (p->index[i])
+               pBigger->children[i] = p->children[p->index[i] - 1];
+         delete p;
+         ref = pBigger;
+         break;
+      }
+      default:
+      {
+         Node256* p = static_cast<Node256*>(ref);
+         p->children[b] = pChild;
+         p->numChildren++;
+         return;
+      }
+   }
+   // It grew, and now has room
+   addChild(ref, b, pChild);
+}
+
+/*****************************************************
+ * ART MAP :: REMOVE CHILD
+ * Take out the slot for byte b, which must be there
+ ****************************************************/
+template <typename K, typename V>
+void art_map <K, V> :: removeChild(Inner* pNode, uint8_t b)
+{
+   switch (pNode->type)
+   {
+      case NODE4:
+      case NODE16:
+      {
+         uint8_t* keys = pNode->type == NODE4 ? static_cast<Node4*>(pNode)->keys
+                                              : static_cast<Node16*>(pNode)->keys;
+         Header** children = pNode->type == NODE4 ? static_cast<Node4*>(pNode)->children
+                                                  : static_cast<Node16*>(pNode)->children;
+         int i = 0;
+         while (keys[i] != b)
+            i++;
+         for (; i + 1 < pNode->numChildren; i++)
+         {
+            keys[i] = keys[i + 1];
+            children[i] = children[i + 1];
+         }
+         break;
+      }
+      case NODE48:
+      {
+         Node48* p = static_cast<Node48*>(pNode);
+         p->children[p->index[b] - 1] = nullptr;
+         p->index[b] = 0;
+         break;
+      }
+      default:
+         static_cast<Node256*>(pNode)->children[b] = nullptr;
+   }
+   pNode->numChildren--;
+}
+
+/*****************************************************
+ * ART MAP :: SHRINK
+ * After a removal, move the node at ref down a size
+ * once it is well under the smaller size's capacity,
+ * so a key going back in does not grow it again. A
+ * Node4 with one child and no value of its own folds
+ * into that child; with only a value, it becomes it.
+ ****************************************************/
+template <typename K, typename V>
+void art_map <K, V> :: shrink(Header*& ref)
+{
+   Inner* pInner = static_cast<Inner*>(ref);
+   switch (ref->type)
+   {
+      case NODE4:
+      {
+         Node4* p = static_cast<Node4*>(ref);
+         if (p->numChildren == 0)
+         {
+            ref = p->pValue;
+            delete p;
+         }
+         else if (p->numChildren == 1 && p->pValue == nullptr)
+         {
+            Header* pChild = p->children[0];
+            if (pChild->type != LEAF)
+            {
+               Inner* pChildInner = static_cast<Inner*>(pChild);
+               pChildInner->prefix = p->prefix + (char)p->keys[0] + pChildInner->prefix;
+            }
+            ref = pChild;
+            delete p;
+         }
+         return;
+      }
+      case NODE16:
+      {
+         Node16* p = static_cast<Node16*>(ref);
+         if (p->numChildren > 3)
+            return;
+         Node4* pSmaller = new Node4;
+         for (int i = 0; i < p->numChildren; i++)
+         {
+            pSmaller->keys[i] = p->keys[i];
+            pSmaller->children[i] = p->children[i];
+         }
+         ref = pSmaller;
+         break;
+      }
+      case NODE48:
+      {
+         Node48* p = static_cast<Node48*>(ref);
+         if (p->numChildren > 12)
+            return;
+         Node16* pSmaller = new Node16;
+         int n = 0;
+         for (int i = 0; i < 256; i++)
+            if (p->index[i])
+            {
+               pSmaller->keys[n] = (uint8_t)i;
+               pSmaller->children[n++] = p->children[p->index[i] - 1];
+            }
+         ref = pSmaller;
+         break;
+      }
+      default:
+      {
+         Node256* p = static_cast<Node256*>(ref);
+         if (p->numChildren > 37)
+            return;
+         Node48* pSmaller = new Node48;
+         int n = 0;
+         for (int i = 0; i < 256; i++)
+            if (p->children[i])
+            {
+               pSmaller->index[i] = (uint8_t)(n + 1);
+               pSmaller->children[n++] = p->children[i];
+            }
+         ref = pSmaller;
+         break;
+      }
+   }
+
+   // Carry the rest over to the smaller node
+   Inner* pSmaller = static_cast<Inner*>(ref);
+   pSmaller->prefix = std::move(pInner->prefix);
+   pSmaller->pValue = pInner->pValue;
+   pSmaller->numChildren = pInner->numChildren;
+   switch (pInner->type)
+   {
+      case NODE16: delete static_cast<Node16*>(pInner);  break;
+      case NODE48: delete static_cast<Node48*>(pInner);  break;
+      default:     delete static_cast<Node256*>(pInner); break;
+   }
+}
+
+/*****************************************************
+ * ART MAP :: SEARCH
+ * The leaf for k, or null. The prefixes are skipped,
+ * not compared: the leaf holds the whole key, and
+ * one compare there catches any difference on the
+ * way down.
+ ****************************************************/
+template <typename K, typename V>
+typename art_map <K, V> :: Leaf*
+art_map <K, V> :: search(const K& k) const
+{
+   size_t length = Key::size(k);
+   size_t depth = 0;
+   Header* pNode = root;
+   while (pNode && pNode->type != LEAF)
+   {
+      Inner* pInner = static_cast<Inner*>(pNode);
+      depth += pInner->prefix.size();
+      if (depth > length)
+         return nullptr;
+      if (depth == length)
+      {
+         pNode = pInner->pValue;
+         break;
+      }
+      Header** ppChild = findChild(pInner, Key::at(k, depth));
+      pNode = ppChild ? *ppChild : nullptr;
+      depth++;
+   }
+   Leaf* pLeaf = static_cast<Leaf*>(pNode);
+   return (pLeaf && sameKey(pLeaf->data.first, k)) ? pLeaf : nullptr;
+}
+
+/*****************************************************
+ * ART MAP :: MINIMUM and MAXIMUM
+ * The first and last leaves below a node. A node's
+ * own value is shorter than, so before, its children.
+ ****************************************************/
+template <typename K, typename V>
+typename art_map <K, V> :: Leaf*
+art_map <K, V> :: minimum(Header* pNode)
+{
+   while (pNode->type != LEAF)
+   {
+      Inner* pInner = static_cast<Inner*>(pNode);
+      if (pInner->pValue)
+         return pInner->pValue;
+      pNode = childFrom(pInner, 0);
+   }
+   return static_cast<Leaf*>(pNode);
+}
+template <typename K, typename V>
+typename art_map <K, V> :: Leaf*
+art_map <K, V> :: maximum(Header* pNode)
+{
+   while (pNode->type != LEAF)
+   {
+      Inner* pInner = static_cast<Inner*>(pNode);
+      Header* pLast = childBefore(pInner, 256);
+      if (pLast == nullptr)
+         return pInner->pValue;
+      pNode = pLast;
+   }
+   return static_cast<Leaf*>(pNode);
+}
+
+/*****************************************************
+ * ART MAP :: SEEK ABOVE
+ * The first leaf below pNode whose key is at least k,
+ * or more than k if strict. depth bytes of k have
+ * already been matched on the way down.
+ ****************************************************/
+template <typename K, typename V>
+typename art_map <K, V> :: Leaf*
+art_map <K, V> :: seekAbove(Header* pNode, size_t depth, const K& k, bool strict)
+{
+   if (pNode == nullptr)
+      return nullptr;
+   if (pNode->type == LEAF)
+   {
+      Leaf* pLeaf = static_cast<Leaf*>(pNode);
+      int diff = compareKeys(pLeaf->data.first, k);
+      return (diff > 0 || (diff == 0 && !strict)) ? pLeaf : nullptr;
+   }
+
+   // Everything here differs from k within the prefix, or extends it
+   Inner* pInner = static_cast<Inner*>(pNode);
+   size_t length = Key::size(k);
+   for (size_t i = 0; i < pInner->prefix.size(); i++, depth++)
+   {
+      if (depth == length)
+         return minimum(pNode);
+      uint8_t b = (uint8_t)pInner->prefix[i];
+      if (b != Key::at(k, depth))
+         return b > Key::at(k, depth) ? minimum(pNode) : nullptr;
+   }
+
+   // k ends here: the value is k itself, and the children follow it
+   if (depth == length)
+   {
+      if (pInner->pValue && !strict)
+         return pInner->pValue;
+      Header* pFirst = childFrom(pInner, 0);
+      return pFirst ? minimum(pFirst) : nullptr;
+   }
+
+   // The value is shorter than k, so before it. Try k's own child,
+   // then the smallest leaf of the next child after it.
+   uint8_t b = Key::at(k, depth);
+   Header** ppChild = findChild(pInner, b);
+   if (ppChild)
+   {
+      Leaf* pLeaf = seekAbove(*ppChild, depth + 1, k, strict);
+      if (pLeaf)
+         return pLeaf;
+   }
+   Header* pNext = childFrom(pInner, b + 1);
+   return pNext ? minimum(pNext) : nullptr;
+}
+
+/*****************************************************
+ * ART MAP :: SEEK BELOW
+ * The last leaf below pNode whose key is less than k
+ ****************************************************/
+template <typename K, typename V>
+typename art_map <K, V> :: Leaf*
+art_map <K, V> :: seekBelow(Header* pNode, size_t depth, const K& k)
+{
+   if (pNode == nullptr)
+      return nullptr;
+   if (pNode->type == LEAF)
+   {
+      Leaf* pLeaf = static_cast<Leaf*>(pNode);
+      return compareKeys(pLeaf->data.first, k) < 0 ? pLeaf : nullptr;
+   }
+
+   Inner* pInner = static_cast<Inner*>(pNode);
+   size_t length = Key::size(k);
+   for (size_t i = 0; i < pInner->prefix.size(); i++, depth++)
+   {
+      if (depth == length)
+         return nullptr;
+      uint8_t b = (uint8_t)pInner->prefix[i];
+      if (b != Key::at(k, depth))
+         return b < Key::at(k, depth) ? maximum(pNode) : nullptr;
+   }
+   if (depth == length)
+      return nullptr;
+
+   uint8_t b = Key::at(k, depth);
+   Header** ppChild = findChild(pInner, b);
+   if (ppChild)
+   {
+      Leaf* pLeaf = seekBelow(*ppChild, depth + 1, k);
+      if (pLeaf)
+         return pLeaf;
+   }
+   Header* pPrev = childBefore(pInner, b);
+   return pPrev ? maximum(pPrev) : pInner->pValue;
+}
+
+/*****************************************************
+ * ART MAP :: WALK
+ * Call f on every pair below a node, in order
+ ****************************************************/
+template <typename K, typename V>
+template <class Function>
+void art_map <K, V> :: walk(const Header* pNode, Function& f)
+{
+   if (pNode->type == LEAF)
+   {
+      f(static_cast<const Leaf*>(pNode)->data);
+      return;
+   }
+   const Inner* pInner = static_cast<const Inner*>(pNode);
+   if (pInner->pValue)
+      f(pInner->pValue->data);
+   switch (pNode->type)
+   {
+      case NODE4:
+      {
+         const Node4* p = static_cast<const Node4*>(pNode);
+         for (int i = 0; i < p->numChildren; i++)
+            walk(p->children[i], f);
+         break;
+      }
+      case NODE16:
+      {
+         const Node16* p = static_cast<const Node16*>(pNode);
+         for (int i = 0; i < p->numChildren; i++)
+            walk(p->children[i], f);
+         break;
+      }
+      case NODE48:
+      {
+         const Node48* p = static_cast<const Node48*>(pNode);
+         for (int i = 0; i < 256; i++)
+            if (p->index[i])
+               walk(p->children[p->index[i] - 1], f);
+         break;
+      }
+      default:
+      {
+         const Node256* p = static_cast<const Node256*>(pNode);
+         for (int i = 0; i < 256; i++)
+            if (p->children[i])
+               walk(p->children[i], f);
+         break;
+      }
+   }
+}
+
+/*****************************************************
+ * ART MAP :: INSERT AT
+ * Put rhs in the subtree at ref, depth bytes down.
+ * pLeaf is set to the leaf for the key, new or old.
+ ****************************************************/
+template <typename K, typename V>
+bool art_map <K, V> :: insertAt(Header*& ref, const Pairs& rhs, size_t depth, Leaf*& pLeaf)
+{
+   const K& k = rhs.first;
+   size_t length = Key::size(k);
+
+   // An empty spot: the key is just a leaf
+   if (ref == nullptr)
+   {
+      ref = pLeaf = new Leaf(rhs);
+      return true;
+   }
+
+   // A leaf: split it into a Node4 over the bytes the two keys share
+   if (ref->type == LEAF)
+   {
+      Leaf* pOld = static_cast<Leaf*>(ref);
+      const K& kOld = pOld->data.first;
+      if (sameKey(kOld, k))
+      {
+         pLeaf = pOld;
+         return false;
+      }
+      size_t lengthOld = Key::size(kOld);
+      Node4* pNode = new Node4;
+      while (depth < length && depth < lengthOld && Key::at(k, depth) == Key::at(kOld, depth))
+         pNode->prefix.push_back((char)Key::at(k, depth++));
+      pLeaf = new Leaf(rhs);
+      Header* pNew = pNode;
+      if (depth == lengthOld)
+         pNode->pValue = pOld;
+      else
+         addChild(pNew, Key::at(kOld, depth), pOld);
+      if (depth == length)
+         pNode->pValue = pLeaf;
+      else
+         addChild(pNew, Key::at(k, depth), pLeaf);
+      ref = pNew;
+      return true;
+   }
+
+   // An inner node whose prefix k leaves early: split the prefix
+   Inner* pInner = static_cast<Inner*>(ref);
+   size_t match = 0;
+   while (match < pInner->prefix.size() && depth + match < length &&
+          (uint8_t)pInner->prefix[match] == Key::at(k, depth + match))
+      match++;
+   if (match < pInner->prefix.size())
+   {
+      Node4* pNode = new Node4;
+      pNode->prefix = pInner->prefix.substr(0, match);
+      uint8_t b = (uint8_t)pInner->prefix[match];
+      pInner->prefix.erase(0, match + 1);
+      Header* pNew = pNode;
+      addChild(pNew, b, pInner);
+      pLeaf = new Leaf(rhs);
+      if (depth + match == length)
+         pNode->pValue = pLeaf;
+      else
+         addChild(pNew, Key::at(k, depth + match), pLeaf);
+      ref = pNew;
+      return true;
+   }
+
+   // The prefix matches: k ends here, or goes on to a child
+   depth += pInner->prefix.size();
+   if (depth == length)
+   {
+      if (pInner->pValue)
+      {
+         pLeaf = pInner->pValue;
+         return false;
+      }
+      pInner->pValue = pLeaf = new Leaf(rhs);
+      return true;
+   }
+   uint8_t b = Key::at(k, depth);
+   Header** ppChild = findChild(pInner, b);
+   if (ppChild)
+      return insertAt(*ppChild, rhs, depth + 1, pLeaf);
+   pLeaf = new Leaf(rhs);
+   addChild(ref, b, pLeaf);
+   return true;
+}
+
+/*****************************************************
+ * ART MAP :: ERASE FROM
+ * Take k out of the subtree at ref, shrinking the
+ * nodes on the way back up. Returns false if k is
+ * not there.
+ ****************************************************/
+template <typename K, typename V>
+bool art_map <K, V> :: eraseFrom(Header*& ref, const K& k, size_t depth)
+{
+   if (ref == nullptr)
+      return false;
+   if (ref->type == LEAF)
+   {
+      if (!sameKey(static_cast<Leaf*>(ref)->data.first, k))
+         return false;
+      delete static_cast<Leaf*>(ref);
+      ref = nullptr;
+      return true;
+   }
+
+   Inner* pInner = static_cast<Inner*>(ref);
+   size_t length = Key::size(k);
+   for (size_t i = 0; i < pInner->prefix.size(); i++, depth++)
+      if (depth == length || (uint8_t)pInner->prefix[i] != Key::at(k, depth))
+         return false;
+
+   if (depth == length)
+   {
+      if (pInner->pValue == nullptr)
+         return false;
+      delete pInner->pValue;
+      pInner->pValue = nullptr;
+   }
+   else
+   {
+      uint8_t b = Key::at(k, depth);
+      Header** ppChild = findChild(pInner, b);
+      if (ppChild == nullptr || !eraseFrom(*ppChild, k, depth + 1))
+         return false;
+      if (*ppChild == nullptr)
+         removeChild(pInner, b);
+   }
+   shrink(ref);
+   return true;
+}
+
+/*****************************************************
+ * ART MAP :: CLONE
+ * A deep copy of a subtree
+ ****************************************************/
+template <typename K, typename V>
+typename art_map <K, V> :: Header*
+art_map <K, V> :: clone(const Header* pNode)
+{
+   if (pNode == nullptr)
+      return nullptr;
+
+   Inner* pCopy;
+   Header** children;
+   int numSlots;
+   switch (pNode->type)
+   {
+      case LEAF:
+         return new Leaf(*static_cast<const Leaf*>(pNode));
+      case NODE4:
+      {
+         Node4* p = new Node4(*static_cast<const Node4*>(pNode));
+         pCopy = p; children = p->children; numSlots = p->numChildren;
+         break;
+      }
+      case NODE16:
+      {
+         Node16* p = new Node16(*static_cast<const Node16*>(pNode));
+         pCopy = p; children = p->children; numSlots = p->numChildren;
+         break;
+      }
+      case NODE48:
+      {
+         Node48* p = new Node48(*static_cast<const Node48*>(pNode));
+         pCopy = p; children = p->children; numSlots = 48;
+         break;
+      }
+      default:
+      {
+         Node256* p = new Node256(*static_cast<const Node256*>(pNode));
+         pCopy = p; children = p->children; numSlots = 256;
+         break;
+      }
+   }
+   for (int i = 0; i < numSlots; i++)
+      children[i] = clone(children[i]);
+   pCopy->pValue = static_cast<Leaf*>(clone(pCopy->pValue));
+   return pCopy;
+}
+
+/*****************************************************
+ * ART MAP :: DESTROY
+ * Free a subtree
+ ****************************************************/
+template <typename K, typename V>
+void art_map <K, V> :: destroy(Header* pNode)
+{
+   if (pNode == nullptr)
+      return;
+   if (pNode->type == LEAF)
+   {
+      delete static_cast<Leaf*>(pNode);
+      return;
+   }
+
+   Inner* pInner = static_cast<Inner*>(pNode);
+   destroy(pInner->pValue);
+   switch (pNode->type)
+   {
+      case NODE4:
+      {
+         Node4* p = static_cast<Node4*>(pNode);
+         for (int i = 0; i < p->numChildren; i++)
+            destroy(p->children[i]);
+         delete p;
+         break;
+      }
+      case NODE16:
+      {
+         Node16* p = static_cast<Node16*>(pNode);
+         for (int i = 0; i < p->numChildren; i++)
+            destroy(p->children[i]);
+         delete p;
+         break;
+      }
+      case NODE48:
+      {
+         Node48* p = static_cast<Node48*>(pNode);
+         for (int i = 0; i < 48; i++)
+            destroy(p->children[i]);
+         delete p;
+         break;
+      }
+      default:
+      {
+         Node256* p = static_cast<Node256*>(pNode);
+         for (int i = 0; i < 256; i++)
+            destroy(p->children[i]);
+         delete p;
+         break;
+      }
+   }
+}
+
+}
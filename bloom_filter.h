@@ -0,0 +1,272 @@
+/***********************************************************************
+ * Header:
+ *    BLOOM FILTER
+ * Summary:
+ *    Compact sets that answer "definitely not here" or "maybe here"
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        bloom_filter          : A blocked Bloom filter
+ *        counting_bloom_filter : A blocked Bloom filter that supports erase
+ * Author
+ *    Tyler and Braeden
+ ************************************************************************/
+
+#pragma once
+
+#include "vector.h"   // because the blocks are a vector
+#include <cassert>
+#include <cmath>      // for std::log, std::pow and std::ceil
+#include <cstdint>    // for uint8_t, uint32_t and uint64_t
+#include <functional> // for std::hash
+
+class TestBloomFilter;      // forward declaration for unit tests
+
+namespace custom
+{
+
+/************************************************
+ * BLOOM HASH
+ * Everything both filters need from one call to Hash:
+ * which block the key lives in, and a 32-bit seed that
+ * eight odd multipliers turn into one position per word.
+ * The mix step spreads weak hashes such as std::hash<int>.
+ ************************************************/
+struct bloom_hash
+{
+   static constexpr uint32_t salt[8] =
+   {
+      0x47b6137bu, 0x44974d91u, 0x8824ad5bu, 0xa2b7289du,
+      0x705495c7u, 0x2df1424bu, 0x9efc4947u, 0x5c6bfb31u
+   };
+
+   static uint64_t mix(uint64_t h)
+   {
+      h ^= h >> 33;
+      h *= 0xff51afd7ed558ccdull;
+      h ^= h >> 33;
+      h *= 0xc4ceb9fe1a85ec53ull;
+      h ^= h >> 33;
+      return h;
+   }
+
+   // Map the high half onto [0, numBlocks) without a divide
+   static size_t block(uint64_t h, size_t numBlocks)
+   {
+      return (size_t)(((h >> 32) * (uint64_t)numBlocks) >> 32);
+   }
+
+   // Bits per element for a false positive rate p with eight probes:
+   // p = (1 - e^(-8n/m))^8, solved for m/n
+   static double bitsPerElement(double p)
+   {
+      if (p <= 0.0 || p >= 1.0)
+         p = 0.01;
+      return -8.0 / std::log(1.0 - std::pow(p, 1.0 / 8.0));
+   }
+};
+
+/************************************************
+ * BLOOM FILTER
+ * A Bloom filter split into 512-bit blocks, each one
+ * cache line. A key sets one bit in each of its block's
+ * eight words, so insert and contains touch exactly one
+ * line, and contains is eight independent and-tests with
+ * no branches, which the compiler can vectorize.
+ ************************************************/
+template <typename T, typename Hash = std::hash<T>>
+class bloom_filter
+{
+   friend class ::TestBloomFilter;   // give unit tests access to the privates
+public:
+   static constexpr bool can_erase = false;
+
+   //
+   // Construct
+   //
+   bloom_filter(size_t numExpected = 1024, double falsePositiveRate = 0.01) :
+      numElements(0)
+   {
+      double numBits = bloom_hash::bitsPerElement(falsePositiveRate) * (double)numExpected;
+      size_t numBlocks = (size_t)std::ceil(numBits / 512.0);
+      blocks.resize(numBlocks == 0 ? 1 : numBlocks);
+   }
+
+   //
+   // Insert
+   //
+   void insert(const T& t)
+   {
+      uint64_t h = bloom_hash::mix(Hash()(t));
+      Block & b = blocks[bloom_hash::block(h, blocks.size())];
+      uint32_t seed = (uint32_t)h;
+      for (int i = 0; i < 8; i++)
+         b.words[i] |= (uint64_t)1 << ((seed * bloom_hash::salt[i]) >> 26);
+      numElements++;
+   }
+   void merge(const bloom_filter& rhs);
+
+   //
+   // Access
+   //
+   bool contains(const T& t) const
+   {
+      uint64_t h = bloom_hash::mix(Hash()(t));
+      const Block & b = blocks[bloom_hash::block(h, blocks.size())];
+      uint32_t seed = (uint32_t)h;
+      uint64_t missing = 0;
+      for (int i = 0; i < 8; i++)
+         missing |= ~b.words[i] & ((uint64_t)1 << ((seed * bloom_hash::salt[i]) >> 26));
+      return missing == 0;
+   }
+
+   //
+   // Remove
+   //
+   void clear()
+   {
+      for (size_t i = 0; i < blocks.size(); i++)
+         blocks[i] = Block();
+      numElements = 0;
+   }
+
+   //
+   // Status
+   //
+   size_t size() const        { return numElements;   }
+   bool empty() const         { return numElements == 0; }
+   size_t block_count() const { return blocks.size(); }
+
+private:
+   struct alignas(64) Block
+   {
+      Block() : words() { }
+      uint64_t words[8];
+   };
+
+   custom::vector<Block> blocks;   // the bits, one cache line per block
+   size_t numElements;             // number of inserts
+};
+
+/*****************************************
+ * BLOOM FILTER :: MERGE
+ * Take in every key of a filter of the same size
+ ****************************************/
+template <typename T, typename H>
+void bloom_filter<T, H>::merge(const bloom_filter& rhs)
+{
+   assert(blocks.size() == rhs.blocks.size());
+   for (size_t b = 0; b < blocks.size(); b++)
+      for (int i = 0; i < 8; i++)
+         blocks[b].words[i] |= rhs.blocks[b].words[i];
+   numElements += rhs.numElements;
+}
+
+/************************************************
+ * COUNTING BLOOM FILTER
+ * The same idea with an 8-bit counter in place of each
+ * bit, so keys can be erased. To keep one cache line
+ * per key, a block is 64 counters in eight groups of
+ * eight, and a key bumps one counter in each group.
+ * A counter that reaches 255 stays there: it can no
+ * longer tell how many keys share it, so erase leaves
+ * it alone rather than risk a false negative.
+ ************************************************/
+template <typename T, typename Hash = std::hash<T>>
+class counting_bloom_filter
+{
+   friend class ::TestBloomFilter;   // give unit tests access to the privates
+public:
+   static constexpr bool can_erase = true;
+
+   //
+   // Construct
+   //
+   counting_bloom_filter(size_t numExpected = 1024, double falsePositiveRate = 0.01) :
+      numElements(0)
+   {
+      // Eight counters per group fill faster than free bits would, so
+      // take half again as many to stay near the requested rate
+      double numCounters = 1.5 * bloom_hash::bitsPerElement(falsePositiveRate) * (double)numExpected;
+      size_t numBlocks = (size_t)std::ceil(numCounters / 64.0);
+      blocks.resize(numBlocks == 0 ? 1 : numBlocks);
+   }
+
+   //
+   // Insert
+   //
+   void insert(const T& t)
+   {
+      unsigned offsets[8];
+      uint8_t * counters = blocks[locate(t, offsets)].counters;
+      for (int i = 0; i < 8; i++)
+         counters[offsets[i]] += (counters[offsets[i]] != 255);
+      numElements++;
+   }
+
+   //
+   // Access
+   //
+   bool contains(const T& t) const
+   {
+      unsigned offsets[8];
+      const uint8_t * counters = blocks[locate(t, offsets)].counters;
+      bool zero = false;
+      for (int i = 0; i < 8; i++)
+         zero |= counters[offsets[i]] == 0;
+      return !zero;
+   }
+
+   //
+   // Remove. Only erase a key that was inserted.
+   //
+   void erase(const T& t)
+   {
+      unsigned offsets[8];
+      uint8_t * counters = blocks[locate(t, offsets)].counters;
+      for (int i = 0; i < 8; i++)
+         counters[offsets[i]] -= (counters[offsets[i]] != 255 && counters[offsets[i]] != 0);
+      if (numElements)
+         numElements--;
+   }
+   void clear()
+   {
+      for (size_t i = 0; i < blocks.size(); i++)
+         blocks[i] = Block();
+      numElements = 0;
+   }
+
+   //
+   // Status
+   //
+   size_t size() const        { return numElements;   }
+   bool empty() const         { return numElements == 0; }
+   size_t block_count() const { return blocks.size(); }
+
+private:
+   struct alignas(64) Block
+   {
+      Block() : counters() { }
+      uint8_t counters[64];
+   };
+
+   // The block for t, and its eight counters there, one from each group
+   size_t locate(const T& t, unsigned offsets[8]) const
+   {
+      uint64_t h = bloom_hash::mix(Hash()(t));
+      uint32_t seed = (uint32_t)h;
+      for (int i = 0; i < 8; i++)
+         offsets[i] = i * 8 + ((seed * bloom_hash::salt[i]) >> 29);
+      return bloom_hash::block(h, blocks.size());
+   }
+
+   custom::vector<Block> blocks;   // the counters, one cache line per block
+   size_t numElements;             // inserts less erases
+};
+
+}
@@ -58,14 +58,32 @@ public:
 
 /*******************************************************************
  * SIZE BTREE
- * Return the size of a b-tree under the current node
+ * Return the size of a b-tree under the current node. Walks down
+ * and back up through the parent pointers rather than recursing.
  *******************************************************************/
 template <class T>
 inline size_t size(const BNode <T> * p)
 {
-   if (p != nullptr)
-      return size(p->pLeft) + 1 + size(p->pRight);
-   return 0;
+   size_t count = 0;
+   const BNode <T> * pTop = p;
+   while (p != nullptr)
+   {
+      count++;
+
+      // Advance to the next node in pre-order
+      if (p->pLeft != nullptr)
+         p = p->pLeft;
+      else if (p->pRight != nullptr)
+         p = p->pRight;
+      else
+      {
+         while (p != pTop &&
+                (p == p->pParent->pRight || p->pParent->pRight == nullptr))
+            p = p->pParent;
+         p = (p == pTop) ? nullptr : p->pParent->pRight;
+      }
+   }
+   return count;
 }
 
 
@@ -135,19 +153,33 @@ void addRight(BNode <T>* pNode, T && t)
 
 /*****************************************************
  * DELETE BINARY TREE
- * Delete all the nodes below pThis including pThis
- * using postfix traverse: LRV
+ * Delete all the nodes below pThis including pThis.
+ * Rotates each left child up until there is none, then
+ * deletes the node and moves right. No recursion and no
+ * stack, so even a degenerate tree cannot overflow.
+ *   COST   : O(n)
  ****************************************************/
 template <class T>
 void clear(BNode <T> * & pThis)
 {
-   if (pThis != nullptr)
+   BNode <T> * p = pThis;
+   while (p != nullptr)
    {
-      clear(pThis->pLeft);
-      clear(pThis->pRight);
-      delete pThis;
-      pThis = nullptr;
+      if (p->pLeft != nullptr)
+      {
+         BNode <T> * pLeft = p->pLeft;
+         p->pLeft = pLeft->pRight;
+         pLeft->pRight = p;
+         p = pLeft;
+      }
+      else
+      {
+         BNode <T> * pRight = p->pRight;
+         delete p;
+         p = pRight;
+      }
    }
+   pThis = nullptr;
 }
 
 /***********************************************
@@ -165,29 +197,23 @@ inline void swap(BNode <T>*& pLHS, BNode <T>*& pRHS)
  * COPY BINARY TREE
  * Copy pSrc->pRight to pDest->pRight and
  * pSrc->pLeft onto pDest->pLeft
+ *   COST   : O(n)
  *********************************************/
 template <class T>
 BNode <T> * copy(const BNode <T> * pSrc) 
 {
-   if (pSrc == nullptr)
-      return nullptr;
-   BNode <T> * destination = new BNode<T> (pSrc->data);
-   
-   destination->pLeft = copy(pSrc->pLeft);
-   if (destination->pLeft != nullptr)
-      destination->pLeft->pParent = destination;
-   
-   destination->pRight = copy(pSrc->pRight);
-   if (destination->pRight != nullptr)
-      destination->pRight->pParent = destination;
-   
+   BNode <T> * destination = nullptr;
+   assign(destination, pSrc);
    return destination;
 }
 
 /**********************************************
  * assign
  * copy the values from pSrc onto pDest preserving
- * as many of the nodes as possible.
+ * as many of the nodes as possible. Both trees are
+ * walked together in pre-order, climbing back up
+ * through the parent pointers instead of recursing.
+ *   COST   : O(n)
  *********************************************/
 template <class T>
 void assign(BNode <T> * & pDest, const BNode <T>* pSrc)
@@ -200,24 +226,54 @@ void assign(BNode <T> * & pDest, const BNode <T>* pSrc)
    
    // Create new node if pDest is null
    if (pDest == nullptr)
-   {
       pDest = new BNode<T>(pSrc->data);
-   }
-   
-   // Only update data if pDest already exists
    else
-   {
-      // Only update data if pDest already exists
       pDest->data = pSrc->data;
-   }
 
-   // Recursive call for the right child
-   assign(pDest->pRight, pSrc->pRight);
-   if (pDest->pRight)
-      pDest->pRight->pParent = pDest;
-   
-   // Recursive call for the left child
-   assign(pDest->pLeft, pSrc->pLeft);
-   if (pDest->pLeft)
-      pDest->pLeft->pParent = pDest;
+   const BNode <T> * pS = pSrc;
+   BNode <T> * pD = pDest;
+   for (;;)
+   {
+      // Make the children of pD match the children of pS,
+      // reusing a destination node wherever there is one
+      if (pS->pLeft == nullptr)
+         clear(pD->pLeft);
+      else if (pD->pLeft == nullptr)
+         addLeft(pD, new BNode<T>(pS->pLeft->data));
+      else
+         pD->pLeft->data = pS->pLeft->data;
+
+      if (pS->pRight == nullptr)
+         clear(pD->pRight);
+      else if (pD->pRight == nullptr)
+         addRight(pD, new BNode<T>(pS->pRight->data));
+      else
+         pD->pRight->data = pS->pRight->data;
+
+      // Advance to the next node in pre-order
+      if (pS->pLeft != nullptr)
+      {
+         pS = pS->pLeft;
+         pD = pD->pLeft;
+         continue;
+      }
+      if (pS->pRight != nullptr)
+      {
+         pS = pS->pRight;
+         pD = pD->pRight;
+         continue;
+      }
+
+      // A leaf: climb until we come up from a left child with a right sibling
+      while (pS != pSrc &&
+             (pS == pS->pParent->pRight || pS->pParent->pRight == nullptr))
+      {
+         pS = pS->pParent;
+         pD = pD->pParent;
+      }
+      if (pS == pSrc)
+         return;
+      pS = pS->pParent->pRight;
+      pD = pD->pParent->pRight;
+   }
 }
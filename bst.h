@@ -30,6 +30,9 @@
 #include <memory>     // for std::allocator
 #include <functional> // for std::less
 #include <utility>    // for std::pair
+#include <future>     // for std::async
+#include <thread>     // for std::thread::hardware_concurrency
+#include <system_error> // for std::system_error
 
 class TestBST; // forward declaration for unit tests
 class TestSet;
@@ -107,6 +110,25 @@ public:
    iterator erase(iterator& it);
    void   clear() noexcept;
 
+   //
+   // Node Handles
+   //
+
+   class node_type;
+   node_type extract(iterator it);
+   std::pair<iterator, bool> insert(node_type && nh, bool keepUnique = false);
+   void merge(BST & rhs, bool keepUnique = false);
+
+   //
+   // Set Algebra
+   //
+
+   void split(const T & t, BST & lhs, BST & rhs);
+   void join(BST & lhs, BST & rhs);
+   void set_union       (BST & rhs, bool parallel = false);
+   void set_intersection(BST & rhs, bool parallel = false);
+   void set_difference  (BST & rhs, bool parallel = false);
+
    // 
    // Status
    //
@@ -121,9 +143,34 @@ private:
    class BNode;
    BNode * root;              // root node of the binary search tree
    size_t numElements;        // number of elements currently in the tree
+
+   // trees smaller than this are never worth handing to another thread
+   static const size_t parallelThreshold = 1 << 16;
    
-   void deleteBinaryTree(BNode * pNode);
-   void copyBinaryTree(BNode *& pDest, const BNode * pSrc);
+   void unlinkNode(BNode * pNode);
+   void eraseFixup(BNode * p, BNode * pParent);
+   void rotateInPlace(BNode * p, bool toLeft);
+   static void    deleteBinaryTree(BNode * pNode, int depth = 0);
+   static void    copyBinaryTree(BNode *& pDest, const BNode * pSrc);
+   static BNode * copyNodes(const BNode * pSrc, int depth);
+
+   // join-based building blocks for the set algebra
+   static int     forkDepth();
+   static int     blackHeight(const BNode * p);
+   static BNode * rotateLeft (BNode * p);
+   static BNode * rotateRight(BNode * p);
+   static BNode * joinRight(BNode * pLeft, BNode * pMid, BNode * pRight, int hLeft, int hRight);
+   static BNode * joinLeft (BNode * pLeft, BNode * pMid, BNode * pRight, int hLeft, int hRight);
+   static BNode * joinNodes(BNode * pLeft, BNode * pMid, BNode * pRight);
+   static BNode * joinNodes(BNode * pLeft, int hLeft, BNode * pMid, BNode * pRight, int hRight, int & h);
+   static BNode * joinNodes(BNode * pLeft, BNode * pRight);
+   static BNode * splitLast(BNode * p, int hP, BNode *& pLast, int & h);
+   static void    splitNodes(BNode * p, const T & t, BNode *& pLeft, BNode *& pMid, BNode *& pRight);
+   static void    splitNodes(BNode * p, int hP, const T & t,
+                             BNode *& pLeft, int & hLeft, BNode *& pMid, BNode *& pRight, int & hRight);
+   static BNode * unionNodes       (BNode * p1, BNode * p2, size_t & numDuplicates, int depth);
+   static BNode * intersectionNodes(BNode * p1, BNode * p2, size_t & numKept,       int depth);
+   static BNode * differenceNodes  (BNode * p1, BNode * p2, size_t & numRemoved,    int depth);
 };
 
 
@@ -245,22 +292,21 @@ public:
    iterator & operator ++ ();
    iterator   operator ++ (int postfix)
    {
-      iterator next = this;
-      next;
-      this++;
-      return *next;
+      iterator next(*this);
+      ++(*this);
+      return next;
    }
    iterator & operator -- ();
    iterator   operator -- (int postfix)
    {
-      iterator next = this;
-      next;
-      this--;
-      return *next;
+      iterator next(*this);
+      --(*this);
+      return next;
    }
 
    // must give friend status to remove so it can call getNode() from it
    friend BST <T> :: iterator BST <T> :: erase(iterator & it);
+   friend class BST <T>;
 
 private:
    
@@ -269,6 +315,66 @@ private:
 };
 
 
+/**********************************************************
+ * BINARY SEARCH TREE NODE HANDLE
+ * Owns a single node that has been extracted from a BST so
+ * it can be re-inserted, into this or another tree, without
+ * freeing and reallocating it.
+ *********************************************************/
+template <typename T>
+class BST <T> :: node_type
+{
+   friend class ::TestBST; // give unit tests access to the privates
+   friend class BST <T>;
+public:
+   // constructors, destructor, and assignment: move only
+   node_type() : pNode(nullptr)
+   {
+   }
+   node_type(node_type && rhs) : pNode(rhs.pNode)
+   {
+      rhs.pNode = nullptr;
+   }
+   node_type(const node_type & rhs) = delete;
+   ~node_type()
+   {
+      delete pNode;
+   }
+   node_type & operator = (node_type && rhs)
+   {
+      if (this != &rhs)
+      {
+         delete pNode;
+         pNode = rhs.pNode;
+         rhs.pNode = nullptr;
+      }
+      return *this;
+   }
+   node_type & operator = (const node_type & rhs) = delete;
+   void swap(node_type & rhs)
+   {
+      std::swap(pNode, rhs.pNode);
+   }
+
+   // status
+   bool empty() const { return pNode == nullptr; }
+   explicit operator bool () const { return pNode != nullptr; }
+
+   // access. Writable because the node is not in a tree right now
+   T & value() const
+   {
+      return pNode->data;
+   }
+
+private:
+   explicit node_type(BNode * p) : pNode(p)
+   {
+   }
+
+   BNode * pNode;   // the extracted node, or nullptr
+};
+
+
 
 /*********************************************
  *********************************************
@@ -336,7 +442,21 @@ BST <T> :: ~BST()
 template <typename T>
 BST <T> & BST <T> :: operator = (const BST <T> & rhs)
 {
-   copyBinaryTree(root, rhs.root);
+   if (this == &rhs)
+      return *this;
+
+   // Big trees are cheaper to copy fresh across every core than to
+   // copy onto the nodes we already have one at a time
+   if (rhs.numElements >= parallelThreshold)
+   {
+      // Build the copy before letting go of what we have, so a
+      // throw leaves this tree as it was
+      BNode * pCopy = copyNodes(rhs.root, forkDepth());
+      clear();
+      root = pCopy;
+   }
+   else
+      copyBinaryTree(root, rhs.root);
    numElements = rhs.numElements;
    return *this;
 }
@@ -542,66 +662,242 @@ typename BST<T>::iterator BST<T>::erase(iterator & it)
    iterator next = it;  // Start with the current iterator
    ++next;              // Move to the next iterator before deleting the current one
 
-   // Case 1: Node has no children
-   if (it.pNode->pRight == nullptr && it.pNode->pLeft == nullptr)
+   unlinkNode(it.pNode);
+   delete it.pNode;
+   
+   numElements--;
+   return next;
+}
+
+/*************************************************
+ * BST :: UNLINK NODE
+ * Take a node out of the tree without freeing it.
+ * The node comes back with no parent and no children.
+ ************************************************/
+template <typename T>
+void BST<T>::unlinkNode(BNode * pNode)
+{
+   // pChild moves up into the place of whatever left the tree.
+   // If that was a black node, pChild's path is one black short
+   bool wasRed = pNode->isRed;
+   BNode * pReplace;
+   BNode * pChild;
+   BNode * pChildParent;
+
+   // Case 1 and 2: Node has at most one child, which takes its place
+   if (pNode->pLeft == nullptr || pNode->pRight == nullptr)
    {
-      if (it.pNode->pParent != nullptr)
+      pReplace = (pNode->pLeft != nullptr) ? pNode->pLeft : pNode->pRight;
+      pChild = pReplace;
+      pChildParent = pNode->pParent;
+   }
+
+   // Case 3: Node has 2 children, the in-order successor takes its
+   // place and its colour, so it is the successor's spot that changes
+   else
+   {
+      pReplace = pNode->pRight;
+      while (pReplace->pLeft != nullptr)
+         pReplace = pReplace->pLeft;
+      wasRed = pReplace->isRed;
+      pChild = pReplace->pRight;
+
+      // Pull the successor out from deeper in the right subtree
+      if (pReplace != pNode->pRight)
       {
-         if (it.pNode->pParent->pRight == it.pNode)
-            it.pNode->pParent->pRight = nullptr;
-         else
-            it.pNode->pParent->pLeft = nullptr;
+         pChildParent = pReplace->pParent;
+         pChildParent->addLeft(pChild);
+         pReplace->addRight(pNode->pRight);
       }
-      delete it.pNode;
+      else
+         pChildParent = pReplace;
+      pReplace->addLeft(pNode->pLeft);
+      pReplace->isRed = pNode->isRed;
    }
-   
-   // Case 2: Node has one child
-   else if (it.pNode->pRight == nullptr && it.pNode->pLeft != nullptr)
+
+   // Hook the replacement up to the old parent
+   if (pNode->pParent == nullptr)
    {
-      it.pNode->pLeft->pParent = it.pNode->pParent;
-      if (it.pNode->pParent != nullptr && it.pNode->pParent->pRight == it.pNode)
-         it.pNode->pParent->pRight = it.pNode->pLeft;
-      if (it.pNode->pParent != nullptr && it.pNode->pParent->pLeft == it.pNode)
-         it.pNode->pParent->pLeft = it.pNode->pLeft;
-      delete it.pNode;
+      root = pReplace;
+      if (pReplace != nullptr)
+         pReplace->pParent = nullptr;
    }
-   else if (it.pNode->pLeft == nullptr && it.pNode->pRight != nullptr)
+   else if (pNode->pParent->isLeftChild(pNode))
+      pNode->pParent->addLeft(pReplace);
+   else
+      pNode->pParent->addRight(pReplace);
+
+   pNode->pParent = pNode->pLeft = pNode->pRight = nullptr;
+
+   if (!wasRed)
+      eraseFixup(pChild, pChildParent);
+}
+
+/*************************************************
+ * BST :: ERASE FIXUP
+ * The path through p (which may be nullptr, hence
+ * pParent) is one black short. Borrow from the
+ * sibling's side, or recolour the sibling red and
+ * push the shortage up a level.
+ ************************************************/
+template <typename T>
+void BST<T>::eraseFixup(BNode * p, BNode * pParent)
+{
+   while (p != root && (p == nullptr || !p->isRed))
    {
-      it.pNode->pRight->pParent = it.pNode->pParent;
-      if (it.pNode->pParent != nullptr && it.pNode->pParent->pRight == it.pNode)
-         it.pNode->pParent->pRight = it.pNode->pRight;
-      if (it.pNode->pParent != nullptr && it.pNode->pParent->pLeft == it.pNode)
-         it.pNode->pParent->pLeft = it.pNode->pRight;
-      delete it.pNode;
-   }
-   
-   // Case 3: Node has 2 children
-   else {
-      BNode* successor = next.pNode;
-      BNode* oldNode = it.pNode;
-      
-      if (oldNode->pParent == nullptr)
+      bool isLeft = pParent->isLeftChild(p);
+      BNode * pSibling = isLeft ? pParent->pRight : pParent->pLeft;
+
+      // A red sibling: rotate it up so our sibling is black
+      if (pSibling->isRed)
       {
-         root = successor;
-         successor->pParent = nullptr;
+         pSibling->isRed = false;
+         pParent->isRed = true;
+         rotateInPlace(pParent, isLeft);
+         pSibling = isLeft ? pParent->pRight : pParent->pLeft;
       }
-      else if (oldNode->pParent->pLeft == oldNode)
-         oldNode->pParent->addLeft(successor);
-      else
-         oldNode->pParent->addRight(successor);
-      
-      BNode* oldRight = oldNode->pRight;
-      oldNode->pRight->addLeft(successor->pRight);
-      successor->addLeft(oldNode->pLeft);
-      
-      if (oldRight != successor)
-         successor->addRight(oldNode->pRight);
-      
-      delete oldNode;
+
+      BNode * pNear = isLeft ? pSibling->pLeft  : pSibling->pRight;
+      BNode * pFar  = isLeft ? pSibling->pRight : pSibling->pLeft;
+
+      // Both nephews black: the sibling's side gives up a black too
+      if ((pNear == nullptr || !pNear->isRed) && (pFar == nullptr || !pFar->isRed))
+      {
+         pSibling->isRed = true;
+         p = pParent;
+         pParent = p->pParent;
+         continue;
+      }
+
+      // Only the near nephew is red: turn it into the far one
+      if (pFar == nullptr || !pFar->isRed)
+      {
+         pNear->isRed = false;
+         pSibling->isRed = true;
+         rotateInPlace(pSibling, !isLeft);
+         pFar = pSibling;
+         pSibling = isLeft ? pParent->pRight : pParent->pLeft;
+      }
+
+      // The far nephew is red: rotate the parent down to our side
+      pSibling->isRed = pParent->isRed;
+      pParent->isRed = false;
+      pFar->isRed = false;
+      rotateInPlace(pParent, isLeft);
+      p = root;
    }
-   
+   if (p != nullptr)
+      p->isRed = false;
+}
+
+/*************************************************
+ * BST :: ROTATE IN PLACE
+ * Rotate the subtree at p left (or right) and hang
+ * the new subtree root where p was
+ ************************************************/
+template <typename T>
+void BST<T>::rotateInPlace(BNode * p, bool toLeft)
+{
+   BNode * pParent = p->pParent;
+   bool wasLeft = pParent != nullptr && pParent->isLeftChild(p);
+   BNode * pNew = toLeft ? rotateLeft(p) : rotateRight(p);
+
+   if (pParent == nullptr)
+      root = pNew;
+   else if (wasLeft)
+      pParent->addLeft(pNew);
+   else
+      pParent->addRight(pNew);
+}
+
+/*************************************************
+ * BST :: EXTRACT
+ * Remove a node from the tree and hand ownership of it
+ * to the caller. Nothing is freed.
+ ************************************************/
+template <typename T>
+typename BST<T>::node_type BST<T>::extract(iterator it)
+{
+   if (it == end())
+      return node_type();
+
+   unlinkNode(it.pNode);
+   it.pNode->isRed = true;
    numElements--;
-   return next;
+   return node_type(it.pNode);
+}
+
+/*****************************************************
+ * BST :: INSERT
+ * Link a previously extracted node into the tree. If the
+ * node is rejected as a duplicate it stays in the handle.
+ ****************************************************/
+template <typename T>
+std::pair<typename BST <T> :: iterator, bool> BST <T> :: insert(node_type && nh, bool keepUnique)
+{
+   if (nh.empty())
+      return std::pair<iterator, bool>(end(), false);
+
+   BNode * pNew = nh.pNode;
+   BNode * pParent = nullptr;
+   BNode * p = root;
+   bool putLeft = true;
+
+   // Loop until it finds where to place the node
+   while (p != nullptr)
+   {
+      pParent = p;
+
+      // If keepUnique prevent duplicates from being inserted
+      if (keepUnique && pNew->data == p->data)
+         return std::pair<iterator, bool>(iterator(p), false);
+
+      putLeft = pNew->data < p->data;
+      p = putLeft ? p->pLeft : p->pRight;
+   }
+
+   // The tree owns the node from here on
+   nh.pNode = nullptr;
+   if (pParent == nullptr)
+      root = pNew;
+   else if (putLeft)
+      pParent->addLeft(pNew);
+   else
+      pParent->addRight(pNew);
+
+   // Increment the elements and balance the tree
+   numElements++;
+   pNew->balance();
+
+   // Find the new root node
+   while (root->pParent != nullptr)
+      root = root->pParent;
+
+   return std::pair<iterator, bool>(iterator(pNew), true);
+}
+
+/*****************************************************
+ * BST :: MERGE
+ * Move the nodes of rhs into this tree. When keepUnique
+ * is set, elements we already have are left behind in rhs.
+ ****************************************************/
+template <typename T>
+void BST <T> :: merge(BST <T> & rhs, bool keepUnique)
+{
+   if (this == &rhs)
+      return;
+
+   iterator it = rhs.begin();
+   while (it != rhs.end())
+   {
+      // Extracting relinks the tree but frees nothing, so the
+      // successor we step to next is still a valid node
+      iterator itNext = it;
+      ++itNext;
+      if (!keepUnique || find(*it) == end())
+         insert(rhs.extract(it), keepUnique);
+      it = itNext;
+   }
 }
 
 
@@ -612,11 +908,10 @@ typename BST<T>::iterator BST<T>::erase(iterator & it)
 template <typename T>
 void BST <T> ::clear() noexcept
 {
-   for (iterator it = begin(); it != end();)
-   {
-       it = erase(it); // Erase returns the next iterator
-   }
-   root = nullptr; // Set root to nullptr after clearing
+   // No need to rebalance a tree we are throwing away
+   deleteBinaryTree(root, numElements >= parallelThreshold ? forkDepth() : 0);
+   root = nullptr;
+   numElements = 0;
 }
 
 /*****************************************************
@@ -662,6 +957,676 @@ typename BST <T> :: iterator BST<T> :: find(const T & t)
    return end();
 }
 
+/*****************************************************
+ * BST :: SPLIT
+ * Move every element less than t into lhs and every
+ * element greater than or equal to t into rhs, leaving
+ * this tree empty unless it is one of the two. No nodes
+ * are allocated or freed.
+ *    COST : O(log n) to relink, O(min(|lhs|, |rhs|)) to count
+ ****************************************************/
+template <typename T>
+void BST <T> :: split(const T & t, BST <T> & lhs, BST <T> & rhs)
+{
+   assert(&lhs != &rhs);
+
+   // Detach first: lhs or rhs may be this tree
+   BNode * pRoot = root;
+   size_t num = numElements;
+   root = nullptr;
+   numElements = 0;
+   lhs.clear();
+   rhs.clear();
+
+   BNode * pLeft;
+   BNode * pMid;
+   BNode * pRight;
+   splitNodes(pRoot, t, pLeft, pMid, pRight);
+   if (pMid != nullptr)
+      pRight = joinNodes(nullptr, pMid, pRight);
+
+   lhs.root = pLeft;
+   rhs.root = pRight;
+   if (lhs.root)
+      lhs.root->isRed = false;
+   if (rhs.root)
+      rhs.root->isRed = false;
+
+   // The sizes are not stored in the nodes, so walk both halves in
+   // lock-step and stop as soon as the smaller one runs out
+   size_t numLeft = 0;
+   size_t numRight = 0;
+   iterator itLeft = lhs.begin();
+   iterator itRight = rhs.begin();
+   while (itLeft != lhs.end() && itRight != rhs.end())
+   {
+      ++itLeft;
+      ++itRight;
+      numLeft++;
+      numRight++;
+   }
+   if (itLeft == lhs.end())
+      numRight = num - numLeft;
+   else
+      numLeft = num - numRight;
+
+   lhs.numElements = numLeft;
+   rhs.numElements = numRight;
+}
+
+/*****************************************************
+ * BST :: JOIN
+ * Replace this tree with lhs followed by rhs. Every element
+ * of lhs must be less than every element of rhs. Both
+ * lhs and rhs are left empty.
+ *    COST : O(log n)
+ ****************************************************/
+template <typename T>
+void BST <T> :: join(BST <T> & lhs, BST <T> & rhs)
+{
+   BNode * pLeft = lhs.root;
+   BNode * pRight = rhs.root;
+   size_t num = lhs.numElements + rhs.numElements;
+   lhs.root = rhs.root = nullptr;
+   lhs.numElements = rhs.numElements = 0;
+
+   clear();
+   root = joinNodes(pLeft, pRight);
+   if (root)
+      root->isRed = false;
+   numElements = num;
+}
+
+/*****************************************************
+ * BST :: SET UNION
+ * Move every element of rhs that is not already here into
+ * this tree. The nodes of rhs are reused; its duplicates
+ * are freed. rhs is left empty.
+ *    COST : O(m log(n/m + 1)) where m <= n
+ ****************************************************/
+template <typename T>
+void BST <T> :: set_union(BST <T> & rhs, bool parallel)
+{
+   if (this == &rhs)
+      return;
+
+   size_t numDuplicates = 0;
+   bool fork = parallel && numElements + rhs.numElements >= parallelThreshold;
+   root = unionNodes(root, rhs.root, numDuplicates, fork ? forkDepth() : 0);
+   if (root)
+      root->isRed = false;
+
+   numElements = numElements + rhs.numElements - numDuplicates;
+   rhs.root = nullptr;
+   rhs.numElements = 0;
+}
+
+/*****************************************************
+ * BST :: SET INTERSECTION
+ * Keep only the elements that are also in rhs. Nodes
+ * that do not survive are freed. rhs is left empty.
+ *    COST : O(m log(n/m + 1)) where m <= n
+ ****************************************************/
+template <typename T>
+void BST <T> :: set_intersection(BST <T> & rhs, bool parallel)
+{
+   if (this == &rhs)
+      return;
+
+   size_t numKept = 0;
+   bool fork = parallel && numElements + rhs.numElements >= parallelThreshold;
+   root = intersectionNodes(root, rhs.root, numKept, fork ? forkDepth() : 0);
+   if (root)
+      root->isRed = false;
+
+   numElements = numKept;
+   rhs.root = nullptr;
+   rhs.numElements = 0;
+}
+
+/*****************************************************
+ * BST :: SET DIFFERENCE
+ * Remove every element that is also in rhs. Nodes that
+ * do not survive are freed. rhs is left empty.
+ *    COST : O(m log(n/m + 1)) where m <= n
+ ****************************************************/
+template <typename T>
+void BST <T> :: set_difference(BST <T> & rhs, bool parallel)
+{
+   if (this == &rhs)
+   {
+      clear();
+      return;
+   }
+
+   size_t numRemoved = 0;
+   bool fork = parallel && numElements + rhs.numElements >= parallelThreshold;
+   root = differenceNodes(root, rhs.root, numRemoved, fork ? forkDepth() : 0);
+   if (root)
+      root->isRed = false;
+
+   numElements -= numRemoved;
+   rhs.root = nullptr;
+   rhs.numElements = 0;
+}
+
+/******************************************************
+ ******************************************************
+ ******************************************************
+ ********************* JOIN / SPLIT *******************
+ ******************************************************
+ ******************************************************
+ ******************************************************/
+
+/*****************************************************
+ * BST :: FORK DEPTH
+ * How many levels of the recursion should spawn a new
+ * thread so that every core gets a subtree
+ ****************************************************/
+template <typename T>
+int BST <T> :: forkDepth()
+{
+   unsigned int numThreads = std::thread::hardware_concurrency();
+   int depth = 0;
+   while ((1u << depth) < numThreads)
+      depth++;
+   return depth;
+}
+
+/*****************************************************
+ * BST :: BLACK HEIGHT
+ * Number of black nodes on the path to a leaf. Any path
+ * will do in a valid red-black tree, so take the left one.
+ ****************************************************/
+template <typename T>
+int BST <T> :: blackHeight(const BNode * p)
+{
+   int height = 0;
+   for (; p != nullptr; p = p->pLeft)
+      if (!p->isRed)
+         height++;
+   return height;
+}
+
+/*****************************************************
+ * BST :: ROTATE LEFT
+ * Rotate the subtree at p to the left and return the new
+ * subtree root. The caller must attach the returned node.
+ ****************************************************/
+template <typename T>
+typename BST <T> :: BNode * BST <T> :: rotateLeft(BNode * p)
+{
+   BNode * pNew = p->pRight;
+   p->addRight(pNew->pLeft);
+   pNew->addLeft(p);
+   pNew->pParent = nullptr;
+   return pNew;
+}
+
+/*****************************************************
+ * BST :: ROTATE RIGHT
+ * Rotate the subtree at p to the right and return the new
+ * subtree root. The caller must attach the returned node.
+ ****************************************************/
+template <typename T>
+typename BST <T> :: BNode * BST <T> :: rotateRight(BNode * p)
+{
+   BNode * pNew = p->pLeft;
+   p->addLeft(pNew->pRight);
+   pNew->addRight(p);
+   pNew->pParent = nullptr;
+   return pNew;
+}
+
+/*****************************************************
+ * BST :: JOIN RIGHT
+ * pLeft is taller than pRight. Walk down the right spine
+ * of pLeft until we find a black node as tall as pRight
+ * and hang pMid there, fixing red-red violations on the
+ * way back up.
+ ****************************************************/
+template <typename T>
+typename BST <T> :: BNode * BST <T> :: joinRight(BNode * pLeft, BNode * pMid, BNode * pRight,
+                                                 int hLeft, int hRight)
+{
+   // Found the spot: a black (or empty) subtree as tall as pRight
+   if ((pLeft == nullptr || !pLeft->isRed) && hLeft == hRight)
+   {
+      pMid->isRed = true;
+      pMid->addLeft(pLeft);
+      pMid->addRight(pRight);
+      pMid->pParent = nullptr;
+      return pMid;
+   }
+
+   // Keep walking down the right spine
+   int hChild = hLeft - (pLeft->isRed ? 0 : 1);
+   pLeft->addRight(joinRight(pLeft->pRight, pMid, pRight, hChild, hRight));
+
+   // A black node with two reds below it on the right: rotate
+   if (!pLeft->isRed && pLeft->pRight->isRed &&
+       pLeft->pRight->pRight != nullptr && pLeft->pRight->pRight->isRed)
+   {
+      pLeft->pRight->pRight->isRed = false;
+      return rotateLeft(pLeft);
+   }
+   return pLeft;
+}
+
+/*****************************************************
+ * BST :: JOIN LEFT
+ * Mirror image of JOIN RIGHT: pRight is the taller tree
+ ****************************************************/
+template <typename T>
+typename BST <T> :: BNode * BST <T> :: joinLeft(BNode * pLeft, BNode * pMid, BNode * pRight,
+                                                int hLeft, int hRight)
+{
+   // Found the spot: a black (or empty) subtree as tall as pLeft
+   if ((pRight == nullptr || !pRight->isRed) && hLeft == hRight)
+   {
+      pMid->isRed = true;
+      pMid->addLeft(pLeft);
+      pMid->addRight(pRight);
+      pMid->pParent = nullptr;
+      return pMid;
+   }
+
+   // Keep walking down the left spine
+   int hChild = hRight - (pRight->isRed ? 0 : 1);
+   pRight->addLeft(joinLeft(pLeft, pMid, pRight->pLeft, hLeft, hChild));
+
+   // A black node with two reds below it on the left: rotate
+   if (!pRight->isRed && pRight->pLeft->isRed &&
+       pRight->pLeft->pLeft != nullptr && pRight->pLeft->pLeft->isRed)
+   {
+      pRight->pLeft->pLeft->isRed = false;
+      return rotateRight(pRight);
+   }
+   return pRight;
+}
+
+/*****************************************************
+ * BST :: JOIN NODES
+ * Build one red-black tree out of pLeft, pMid, and pRight
+ * where everything in pLeft < pMid < everything in pRight.
+ * The returned root may be red.
+ *    COST : O(log n) to measure the black heights
+ ****************************************************/
+template <typename T>
+typename BST <T> :: BNode * BST <T> :: joinNodes(BNode * pLeft, BNode * pMid, BNode * pRight)
+{
+   int h;
+   return joinNodes(pLeft, blackHeight(pLeft), pMid, pRight, blackHeight(pRight), h);
+}
+
+/*****************************************************
+ * BST :: JOIN NODES
+ * Same as above when the caller already knows the black
+ * heights of pLeft and pRight. h gets that of the result.
+ *    COST : O(|hLeft - hRight| + 1)
+ ****************************************************/
+template <typename T>
+typename BST <T> :: BNode * BST <T> :: joinNodes(BNode * pLeft, int hLeft, BNode * pMid,
+                                                 BNode * pRight, int hRight, int & h)
+{
+   // Blacken both roots so only pMid can introduce a red-red violation
+   if (pLeft != nullptr)
+   {
+      pLeft->pParent = nullptr;
+      if (pLeft->isRed)
+         hLeft++;
+      pLeft->isRed = false;
+   }
+   if (pRight != nullptr)
+   {
+      pRight->pParent = nullptr;
+      if (pRight->isRed)
+         hRight++;
+      pRight->isRed = false;
+   }
+
+   BNode * pRoot;
+   h = hLeft > hRight ? hLeft : hRight;
+
+   if (hLeft > hRight)
+   {
+      pRoot = joinRight(pLeft, pMid, pRight, hLeft, hRight);
+      if (pRoot->isRed && pRoot->pRight != nullptr && pRoot->pRight->isRed)
+      {
+         pRoot->isRed = false;
+         h++;
+      }
+   }
+   else if (hRight > hLeft)
+   {
+      pRoot = joinLeft(pLeft, pMid, pRight, hLeft, hRight);
+      if (pRoot->isRed && pRoot->pLeft != nullptr && pRoot->pLeft->isRed)
+      {
+         pRoot->isRed = false;
+         h++;
+      }
+   }
+   else
+   {
+      pRoot = pMid;
+      pRoot->isRed = true;
+      pRoot->addLeft(pLeft);
+      pRoot->addRight(pRight);
+   }
+
+   pRoot->pParent = nullptr;
+   return pRoot;
+}
+
+/*****************************************************
+ * BST :: JOIN NODES
+ * Same as above without a middle node: borrow the largest
+ * node from pLeft to serve as the middle
+ *    COST : O(log n)
+ ****************************************************/
+template <typename T>
+typename BST <T> :: BNode * BST <T> :: joinNodes(BNode * pLeft, BNode * pRight)
+{
+   if (pLeft == nullptr)
+   {
+      if (pRight != nullptr)
+         pRight->pParent = nullptr;
+      return pRight;
+   }
+
+   BNode * pLast = nullptr;
+   int hRest;
+   int h;
+   pLeft = splitLast(pLeft, blackHeight(pLeft), pLast, hRest);
+   return joinNodes(pLeft, hRest, pLast, pRight, blackHeight(pRight), h);
+}
+
+/*****************************************************
+ * BST :: SPLIT LAST
+ * Detach the largest node of p, whose black height is hP,
+ * into pLast and return what remains of the tree. h gets
+ * the black height of what remains.
+ ****************************************************/
+template <typename T>
+typename BST <T> :: BNode * BST <T> :: splitLast(BNode * p, int hP, BNode *& pLast, int & h)
+{
+   BNode * pLeft = p->pLeft;
+   BNode * pRight = p->pRight;
+   p->pLeft = p->pRight = p->pParent = nullptr;
+   if (pLeft != nullptr)
+      pLeft->pParent = nullptr;
+   if (pRight != nullptr)
+      pRight->pParent = nullptr;
+   int hChild = hP - (p->isRed ? 0 : 1);
+
+   // p is the largest: what remains is its left subtree
+   if (pRight == nullptr)
+   {
+      pLast = p;
+      h = hChild;
+      return pLeft;
+   }
+
+   int hRight;
+   pRight = splitLast(pRight, hChild, pLast, hRight);
+   return joinNodes(pLeft, hChild, p, pRight, hRight, h);
+}
+
+/*****************************************************
+ * BST :: SPLIT NODES
+ * Divide p into the nodes less than t (pLeft), the node
+ * equal to t if there is one (pMid), and the nodes greater
+ * than t (pRight). The returned roots may be red.
+ *    COST : O(log n)
+ ****************************************************/
+template <typename T>
+void BST <T> :: splitNodes(BNode * p, const T & t,
+                           BNode *& pLeft, BNode *& pMid, BNode *& pRight)
+{
+   int hLeft;
+   int hRight;
+   splitNodes(p, blackHeight(p), t, pLeft, hLeft, pMid, pRight, hRight);
+}
+
+/*****************************************************
+ * BST :: SPLIT NODES
+ * Same as above given the black height of p, reporting
+ * those of pLeft and pRight. Each join on the way up costs
+ * the difference of two heights, and those add up to
+ * O(log n) along the path rather than O(log n) apiece.
+ ****************************************************/
+template <typename T>
+void BST <T> :: splitNodes(BNode * p, int hP, const T & t,
+                           BNode *& pLeft, int & hLeft, BNode *& pMid,
+                           BNode *& pRight, int & hRight)
+{
+   if (p == nullptr)
+   {
+      pLeft = pMid = pRight = nullptr;
+      hLeft = hRight = 0;
+      return;
+   }
+
+   // Expose the node and its two subtrees, which are equally tall
+   BNode * pChildLeft = p->pLeft;
+   BNode * pChildRight = p->pRight;
+   p->pLeft = p->pRight = p->pParent = nullptr;
+   if (pChildLeft != nullptr)
+      pChildLeft->pParent = nullptr;
+   if (pChildRight != nullptr)
+      pChildRight->pParent = nullptr;
+   int hChild = hP - (p->isRed ? 0 : 1);
+
+   if (t == p->data)
+   {
+      pLeft = pChildLeft;
+      hLeft = hChild;
+      pMid = p;
+      pRight = pChildRight;
+      hRight = hChild;
+   }
+   else if (t < p->data)
+   {
+      int hSplit;
+      splitNodes(pChildLeft, hChild, t, pLeft, hLeft, pMid, pRight, hSplit);
+      pRight = joinNodes(pRight, hSplit, p, pChildRight, hChild, hRight);
+   }
+   else
+   {
+      int hSplit;
+      splitNodes(pChildRight, hChild, t, pLeft, hSplit, pMid, pRight, hRight);
+      pLeft = joinNodes(pChildLeft, hChild, p, pLeft, hSplit, hLeft);
+   }
+}
+
+/*****************************************************
+ * BST :: UNION NODES
+ * Split p1 around the root of p2, union the two halves
+ * (in parallel while depth > 0), and join them back
+ * around p2's root. When both trees hold an element,
+ * p1's node survives.
+ ****************************************************/
+template <typename T>
+typename BST <T> :: BNode * BST <T> :: unionNodes(BNode * p1, BNode * p2,
+                                                  size_t & numDuplicates, int depth)
+{
+   if (p1 == nullptr)
+      return p2;
+   if (p2 == nullptr)
+      return p1;
+
+   BNode * pLeft2 = p2->pLeft;
+   BNode * pRight2 = p2->pRight;
+   p2->pLeft = p2->pRight = p2->pParent = nullptr;
+
+   BNode * pLeft1;
+   BNode * pDuplicate;
+   BNode * pRight1;
+   splitNodes(p1, p2->data, pLeft1, pDuplicate, pRight1);
+   if (pDuplicate != nullptr)
+   {
+      numDuplicates++;
+      delete p2;
+      p2 = pDuplicate;
+   }
+
+   BNode * pLeft;
+   BNode * pRight;
+   if (depth > 0)
+   {
+      // If no thread can be had, this one does the work
+      size_t numLeft = 0;
+      std::future<BNode *> left;
+      try
+      {
+         left = std::async(std::launch::async, [&]()
+         {
+            return unionNodes(pLeft1, pLeft2, numLeft, depth - 1);
+         });
+      }
+      catch (const std::system_error &)
+      {
+         pLeft = unionNodes(pLeft1, pLeft2, numLeft, 0);
+      }
+      pRight = unionNodes(pRight1, pRight2, numDuplicates, depth - 1);
+      if (left.valid())
+         pLeft = left.get();
+      numDuplicates += numLeft;
+   }
+   else
+   {
+      pLeft = unionNodes(pLeft1, pLeft2, numDuplicates, 0);
+      pRight = unionNodes(pRight1, pRight2, numDuplicates, 0);
+   }
+
+   return joinNodes(pLeft, p2, pRight);
+}
+
+/*****************************************************
+ * BST :: INTERSECTION NODES
+ * Same shape as UNION NODES but only nodes found in
+ * both trees survive. p1's copy is the one kept.
+ ****************************************************/
+template <typename T>
+typename BST <T> :: BNode * BST <T> :: intersectionNodes(BNode * p1, BNode * p2,
+                                                         size_t & numKept, int depth)
+{
+   if (p1 == nullptr || p2 == nullptr)
+   {
+      deleteBinaryTree(p1);
+      deleteBinaryTree(p2);
+      return nullptr;
+   }
+
+   BNode * pLeft2 = p2->pLeft;
+   BNode * pRight2 = p2->pRight;
+   p2->pLeft = p2->pRight = p2->pParent = nullptr;
+
+   BNode * pLeft1;
+   BNode * pDuplicate;
+   BNode * pRight1;
+   splitNodes(p1, p2->data, pLeft1, pDuplicate, pRight1);
+   delete p2;
+
+   BNode * pLeft;
+   BNode * pRight;
+   if (depth > 0)
+   {
+      // If no thread can be had, this one does the work
+      size_t numLeft = 0;
+      std::future<BNode *> left;
+      try
+      {
+         left = std::async(std::launch::async, [&]()
+         {
+            return intersectionNodes(pLeft1, pLeft2, numLeft, depth - 1);
+         });
+      }
+      catch (const std::system_error &)
+      {
+         pLeft = intersectionNodes(pLeft1, pLeft2, numLeft, 0);
+      }
+      pRight = intersectionNodes(pRight1, pRight2, numKept, depth - 1);
+      if (left.valid())
+         pLeft = left.get();
+      numKept += numLeft;
+   }
+   else
+   {
+      pLeft = intersectionNodes(pLeft1, pLeft2, numKept, 0);
+      pRight = intersectionNodes(pRight1, pRight2, numKept, 0);
+   }
+
+   if (pDuplicate == nullptr)
+      return joinNodes(pLeft, pRight);
+   numKept++;
+   return joinNodes(pLeft, pDuplicate, pRight);
+}
+
+/*****************************************************
+ * BST :: DIFFERENCE NODES
+ * Same shape as UNION NODES but nodes found in p2 are
+ * removed from p1. Every node of p2 is freed.
+ ****************************************************/
+template <typename T>
+typename BST <T> :: BNode * BST <T> :: differenceNodes(BNode * p1, BNode * p2,
+                                                       size_t & numRemoved, int depth)
+{
+   if (p1 == nullptr)
+   {
+      deleteBinaryTree(p2);
+      return nullptr;
+   }
+   if (p2 == nullptr)
+      return p1;
+
+   BNode * pLeft2 = p2->pLeft;
+   BNode * pRight2 = p2->pRight;
+   p2->pLeft = p2->pRight = p2->pParent = nullptr;
+
+   BNode * pLeft1;
+   BNode * pDuplicate;
+   BNode * pRight1;
+   splitNodes(p1, p2->data, pLeft1, pDuplicate, pRight1);
+   delete p2;
+   if (pDuplicate != nullptr)
+   {
+      numRemoved++;
+      delete pDuplicate;
+   }
+
+   BNode * pLeft;
+   BNode * pRight;
+   if (depth > 0)
+   {
+      // If no thread can be had, this one does the work
+      size_t numLeft = 0;
+      std::future<BNode *> left;
+      try
+      {
+         left = std::async(std::launch::async, [&]()
+         {
+            return differenceNodes(pLeft1, pLeft2, numLeft, depth - 1);
+         });
+      }
+      catch (const std::system_error &)
+      {
+         pLeft = differenceNodes(pLeft1, pLeft2, numLeft, 0);
+      }
+      pRight = differenceNodes(pRight1, pRight2, numRemoved, depth - 1);
+      if (left.valid())
+         pLeft = left.get();
+      numRemoved += numLeft;
+   }
+   else
+   {
+      pLeft = differenceNodes(pLeft1, pLeft2, numRemoved, 0);
+      pRight = differenceNodes(pRight1, pRight2, numRemoved, 0);
+   }
+
+   return joinNodes(pLeft, pRight);
+}
+
 /******************************************************
  ******************************************************
  ******************************************************
@@ -670,22 +1635,68 @@ typename BST <T> :: iterator BST<T> :: find(const T & t)
  ******************************************************
  ******************************************************/
 
+/**********************************************
+ * BST :: DELETE BINARY TREE
+ * Free every node below pNode including pNode. The top
+ * depth levels hand their left subtree to another thread.
+ * Below that, each left child is rotated up until there is
+ * none, then the node is freed and we move right, so there
+ * is no recursion and no stack however the tree is shaped.
+ *   COST   : O(n)
+ *********************************************/
 template <typename T>
-void  BST <T> :: deleteBinaryTree(BNode * pNode)
+void  BST <T> :: deleteBinaryTree(BNode * pNode, int depth)
 {
-   if (pNode != nullptr)
+   if (depth > 0 && pNode != nullptr)
    {
-      deleteBinaryTree(pNode->pLeft);
-      deleteBinaryTree(pNode->pRight);
+      BNode * pLeft = pNode->pLeft;
+      BNode * pRight = pNode->pRight;
       delete pNode;
-      pNode = nullptr;
+
+      // If no thread can be had, this one does the work
+      std::future<void> left;
+      try
+      {
+         left = std::async(std::launch::async, [pLeft, depth]()
+         {
+            deleteBinaryTree(pLeft, depth - 1);
+         });
+      }
+      catch (const std::system_error &)
+      {
+         deleteBinaryTree(pLeft, 0);
+      }
+      deleteBinaryTree(pRight, depth - 1);
+      if (left.valid())
+         left.get();
+      return;
+   }
+
+   while (pNode != nullptr)
+   {
+      if (pNode->pLeft != nullptr)
+      {
+         BNode * pLeft = pNode->pLeft;
+         pNode->pLeft = pLeft->pRight;
+         pLeft->pRight = pNode;
+         pNode = pLeft;
+      }
+      else
+      {
+         BNode * pRight = pNode->pRight;
+         delete pNode;
+         pNode = pRight;
+      }
    }
 }
 
 /**********************************************
- * assign
+ * BST :: COPY BINARY TREE
  * copy the values from pSrc onto pDest preserving
- * as many of the nodes as possible.
+ * as many of the nodes as possible. Both trees are
+ * walked together in pre-order, climbing back up
+ * through the parent pointers instead of recursing.
+ *   COST   : O(n)
  *********************************************/
 template <typename T>
 void BST<T>::copyBinaryTree(BNode *& pDest, const BNode * pSrc)
@@ -699,26 +1710,140 @@ void BST<T>::copyBinaryTree(BNode *& pDest, const BNode * pSrc)
    
    // Create new node if pDest is null
    if (pDest == nullptr)
-   {
       pDest = new BNode(pSrc->data);
-      pDest->isRed=pSrc->isRed;
-   }
    else
-   {
-      // Update data if pDest already exists
       pDest->data = pSrc->data;
-      pDest->isRed = pSrc->isRed;
+   pDest->isRed = pSrc->isRed;
+
+   const BNode * pS = pSrc;
+   BNode * pD = pDest;
+   for (;;)
+   {
+      // Make the children of pD match the children of pS,
+      // reusing a destination node wherever there is one
+      if (pS->pLeft == nullptr)
+      {
+         deleteBinaryTree(pD->pLeft);
+         pD->pLeft = nullptr;
+      }
+      else
+      {
+         if (pD->pLeft == nullptr)
+            pD->addLeft(new BNode(pS->pLeft->data));
+         else
+            pD->pLeft->data = pS->pLeft->data;
+         pD->pLeft->isRed = pS->pLeft->isRed;
+      }
+
+      if (pS->pRight == nullptr)
+      {
+         deleteBinaryTree(pD->pRight);
+         pD->pRight = nullptr;
+      }
+      else
+      {
+         if (pD->pRight == nullptr)
+            pD->addRight(new BNode(pS->pRight->data));
+         else
+            pD->pRight->data = pS->pRight->data;
+         pD->pRight->isRed = pS->pRight->isRed;
+      }
+
+      // Advance to the next node in pre-order
+      if (pS->pLeft != nullptr)
+      {
+         pS = pS->pLeft;
+         pD = pD->pLeft;
+         continue;
+      }
+      if (pS->pRight != nullptr)
+      {
+         pS = pS->pRight;
+         pD = pD->pRight;
+         continue;
+      }
+
+      // A leaf: climb until we come up from a left child with a right sibling
+      while (pS != pSrc &&
+             (pS == pS->pParent->pRight || pS->pParent->pRight == nullptr))
+      {
+         pS = pS->pParent;
+         pD = pD->pParent;
+      }
+      if (pS == pSrc)
+         return;
+      pS = pS->pParent->pRight;
+      pD = pD->pParent->pRight;
    }
+}
 
-   // Recursive call for the right child
-   copyBinaryTree(pDest->pRight, pSrc->pRight);
-   if (pDest->pRight)
-      pDest->pRight->pParent = pDest;
-   
-   // Recursive call for the left child
-   copyBinaryTree(pDest->pLeft, pSrc->pLeft);
-   if (pDest->pLeft)
-      pDest->pLeft->pParent = pDest;
+/**********************************************
+ * BST :: COPY NODES
+ * Return a fresh copy of pSrc. The top depth levels
+ * copy their left subtree on another thread; below
+ * that it is COPY BINARY TREE. If anything throws,
+ * whatever was built is freed before it is rethrown.
+ *   COST   : O(n)
+ *********************************************/
+template <typename T>
+typename BST <T> :: BNode * BST <T> :: copyNodes(const BNode * pSrc, int depth)
+{
+   BNode * pDest = nullptr;
+   if (depth == 0 || pSrc == nullptr)
+   {
+      try
+      {
+         copyBinaryTree(pDest, pSrc);
+      }
+      catch (...)
+      {
+         deleteBinaryTree(pDest);
+         throw;
+      }
+      return pDest;
+   }
+
+   pDest = new BNode(pSrc->data);
+   pDest->isRed = pSrc->isRed;
+
+   // If no thread can be had, this one does the work
+   std::future<BNode *> left;
+   try
+   {
+      left = std::async(std::launch::async, [pSrc, depth]()
+      {
+         return copyNodes(pSrc->pLeft, depth - 1);
+      });
+   }
+   catch (const std::system_error &)
+   {
+   }
+
+   try
+   {
+      if (!left.valid())
+         pDest->addLeft(copyNodes(pSrc->pLeft, 0));
+      pDest->addRight(copyNodes(pSrc->pRight, depth - 1));
+      if (left.valid())
+         pDest->addLeft(left.get());
+   }
+   catch (...)
+   {
+      // Wait for the other thread so its half is not lost
+      if (left.valid())
+      {
+         try
+         {
+            pDest->addLeft(left.get());
+         }
+         catch (...)
+         {
+         }
+      }
+      deleteBinaryTree(pDest);
+      throw;
+   }
+   return pDest;
 }
 
 /******************************************************
@@ -1003,20 +2128,20 @@ void BST <T> :: BNode :: balance()
          pParent->addRight(this->pLeft);
          
          
-         if (pGranny->pParent == nullptr)
-            this->pParent = nullptr;
-         else if (pGranny->pParent->isRightChild(pGranny))
-            pGranny->pParent->pRight = this;
-         else
-            pGranny->pParent->pLeft = this;
+         this->pParent = pHead;
+         if (pHead != nullptr)
+         {
+            if (pHead->isRightChild(pGranny))
+               pHead->pRight = this;
+            else
+               pHead->pLeft = this;
+         }
          
          this->addRight(pGranny);
          this->addLeft(tempParent);
 
          pGranny->isRed = true;
          this->isRed = false;
-         
-         this->balance();
       }
       
       // case 4d: we are mom's left and mom is granny's right
@@ -1026,20 +2151,20 @@ void BST <T> :: BNode :: balance()
          pGranny->addRight(this->pLeft);
          pParent->addLeft(this->pRight);
          
-         if (pGranny->pParent == nullptr)
-            this->pParent = nullptr;
-         else if (pGranny->pParent->isRightChild(pGranny))
-            pGranny->pParent->pRight = this;
-         else
-            pGranny->pParent->pLeft = this;
+         this->pParent = pHead;
+         if (pHead != nullptr)
+         {
+            if (pHead->isRightChild(pGranny))
+               pHead->pRight = this;
+            else
+               pHead->pLeft = this;
+         }
          
          this->addLeft(pGranny);
          this->addRight(tempParent);
          
          pGranny->isRed = true;
          this->isRed = false;
-         
-         this->balance();
       }
    }
 }
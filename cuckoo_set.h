@@ -0,0 +1,696 @@
+/***********************************************************************
+ * Header:
+ *    CUCKOO SET
+ * Summary:
+ *    A hash set where every element is in one of two buckets
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        cuckoo_set           : A bucketized cuckoo hash set
+ *        cuckoo_set::iterator : An interator through the set
+ * Author
+ *    Tyler and Braeden
+ ************************************************************************/
+
+#pragma once
+
+#include "pair.h"     // for pair
+#include "vector.h"   // because the stash is a vector
+#include <cmath>      // for std::ceil
+#include <cstdint>    // for uint8_t and uint64_t
+#include <functional> // for std::hash and std::equal_to
+#include <memory>     // for std::allocator
+#include <new>        // std::bad_alloc
+#include <stdexcept>  // for std::length_error
+#include <utility>    // for std::swap
+
+class TestCuckoo;           // forward declaration for unit tests
+
+namespace custom
+{
+
+/************************************************
+ * CUCKOO SET
+ * Buckets of four slots. An element's hash picks its
+ * first bucket and a one-byte tag; the tag picks its
+ * second bucket from the first, so either bucket can
+ * find the other without hashing the element again.
+ * find() looks at those two buckets and, only if it is
+ * in use, a stash of at most four elements.
+ *
+ * When both buckets are full, insert searches breadth
+ * first for the shortest chain of elements that can
+ * each move to their other bucket, ending at a free
+ * slot, and shifts the chain along it. If no short
+ * chain exists the element waits in the stash; if the
+ * stash is full too, the table doubles. Only keys whose
+ * hashes are equal can fill a sparse table, and doubling
+ * cannot separate them, so then insert throws
+ * std::length_error instead. A rehash may leave a few
+ * extra in the stash until the next insert grows again.
+ ************************************************/
+template <typename T,
+          typename Hash = std::hash<T>,
+          typename EqPred = std::equal_to<T>,
+          typename A = std::allocator<T> >
+class cuckoo_set
+{
+   friend class ::TestCuckoo;   // give unit tests access to the privates
+
+   static constexpr size_t slotsPerBucket = 4;
+   static constexpr size_t stashCapacity = 4;
+   static constexpr size_t maxSearch = 256;   // buckets the displacement search may visit
+
+   // A bucket fits in one cache line when T is small. A tag of 0 marks an empty slot.
+   struct alignas(64) Bucket
+   {
+      Bucket()
+      {
+         for (size_t s = 0; s < slotsPerBucket; s++)
+            tags[s] = 0;
+      }
+      T * slot(size_t s) { return reinterpret_cast<T *>(buffer) + s; }
+
+      uint8_t tags[slotsPerBucket];
+      alignas(T) unsigned char buffer[slotsPerBucket * sizeof(T)];
+   };
+   using BucketAlloc  = typename std::allocator_traits<A>::template rebind_alloc<Bucket>;
+   using BucketTraits = std::allocator_traits<BucketAlloc>;
+   using Traits       = std::allocator_traits<A>;
+
+public:
+   //
+   // Construct
+   //
+   cuckoo_set() : cuckoo_set(8)
+   {
+   }
+   cuckoo_set(size_t numBuckets) :
+      buckets(nullptr), numBuckets(0), numElements(0), maxLoadFactor(0.9f)
+   {
+      allocate(roundUp(numBuckets));
+   }
+   cuckoo_set(const cuckoo_set& rhs);
+   cuckoo_set(cuckoo_set&& rhs) : cuckoo_set()
+   {
+      swap(rhs);
+   }
+   template <class Iterator>
+   cuckoo_set(Iterator first, Iterator last) : cuckoo_set()
+   {
+      for (; first != last; ++first)
+         insert(*first);
+   }
+   cuckoo_set(const std::initializer_list<T>& il) : cuckoo_set()
+   {
+      insert(il);
+   }
+   ~cuckoo_set()
+   {
+      clear();
+      deallocate();
+   }
+
+   //
+   // Assign
+   //
+   cuckoo_set& operator = (const cuckoo_set& rhs)
+   {
+      cuckoo_set temp(rhs);
+      swap(temp);
+      return *this;
+   }
+   cuckoo_set& operator = (cuckoo_set&& rhs)
+   {
+      cuckoo_set temp(std::move(rhs));
+      swap(temp);
+      return *this;
+   }
+   cuckoo_set& operator = (const std::initializer_list<T>& il)
+   {
+      clear();
+      insert(il);
+      return *this;
+   }
+   void swap(cuckoo_set& rhs)
+   {
+      std::swap(alloc, rhs.alloc);
+      std::swap(bucketAlloc, rhs.bucketAlloc);
+      std::swap(buckets, rhs.buckets);
+      std::swap(numBuckets, rhs.numBuckets);
+      std::swap(numElements, rhs.numElements);
+      std::swap(maxLoadFactor, rhs.maxLoadFactor);
+      stash.swap(rhs.stash);
+   }
+
+   //
+   // Iterator
+   //
+   class iterator;
+   iterator begin()
+   {
+      iterator it(this, 0);
+      if (!it.occupied())
+         ++it;
+      return it;
+   }
+   iterator end()
+   {
+      return iterator(this, numBuckets * slotsPerBucket + stash.size());
+   }
+
+   //
+   // Access
+   //
+   iterator find(const T& t);
+   size_t count(const T& t)
+   {
+      return find(t) == end() ? 0 : 1;
+   }
+
+   //
+   // Insert
+   //
+   custom::pair<iterator, bool> insert(const T& t);
+   custom::pair<iterator, bool> insert(T&& t);
+   void insert(const std::initializer_list<T>& il)
+   {
+      for (auto& t : il)
+         insert(t);
+   }
+   void rehash(size_t numBuckets);
+   void reserve(size_t num)
+   {
+      rehash((size_t)std::ceil(num / maxLoadFactor / slotsPerBucket));
+   }
+
+   //
+   // Remove
+   //
+   void clear() noexcept;
+   iterator erase(const T& t);
+   iterator erase(const iterator& it);
+
+   //
+   // Status
+   //
+   size_t size() const          { return numElements;      }
+   bool empty() const           { return numElements == 0; }
+   size_t bucket_count() const  { return numBuckets;       }
+   size_t bucket_size(size_t i) const
+   {
+      size_t num = 0;
+      for (size_t s = 0; s < slotsPerBucket; s++)
+         num += buckets[i].tags[s] != 0;
+      return num;
+   }
+   float load_factor() const noexcept
+   {
+      return (float)numElements / (float)(numBuckets * slotsPerBucket);
+   }
+   float max_load_factor() const noexcept
+   {
+      return maxLoadFactor;
+   }
+   void max_load_factor(float m)
+   {
+      // Four-slot buckets stop finding room a little past 0.95
+      maxLoadFactor = m > 0.95f ? 0.95f : (m < 0.05f ? 0.05f : m);
+   }
+
+private:
+
+   // One step of a displacement search: a bucket we reached, the step
+   // we reached it from, and which slot of that step's bucket moves here
+   struct Step
+   {
+      size_t iBucket;
+      int    parent;
+      size_t slotFrom;
+   };
+
+   static size_t roundUp(size_t num)
+   {
+      size_t cap = 2;
+      while (cap < num)
+         cap *= 2;
+      return cap;
+   }
+
+   // First bucket and tag from one multiply of the hash
+   void locate(const T& t, size_t& iBucket, uint8_t& tag) const
+   {
+      uint64_t h = (uint64_t)Hash()(t) * 0x9E3779B97F4A7C15ull;
+      tag = (uint8_t)(h >> 56);
+      if (tag == 0)
+         tag = 1;
+      iBucket = (size_t)(h ^ (h >> 32)) & (numBuckets - 1);
+   }
+
+   // The other bucket. Applying it twice gives back iBucket, and the
+   // low bit always flips so the two buckets are never the same.
+   size_t alternate(size_t iBucket, uint8_t tag) const
+   {
+      return (iBucket ^ (((size_t)tag * 0x5bd1e995u) | 1)) & (numBuckets - 1);
+   }
+
+   iterator findIn(size_t iBucket, uint8_t tag, const T& t);
+   iterator insertNew(T&& t, bool rehashing = false);
+   bool placeInBucket(size_t iBucket, uint8_t tag, T&& t, iterator& it);
+   bool displace(size_t iFirst, size_t iSecond, uint8_t tag, T&& t, iterator& it);
+   void allocate(size_t numBuckets);
+   void deallocate();
+
+   A           alloc;           // builds and destroys the elements
+   BucketAlloc bucketAlloc;     // allocates the buckets
+   Bucket *    buckets;         // the buckets, a power of two of them
+   size_t      numBuckets;      // number of buckets
+   size_t      numElements;     // number of elements, stash included
+   float       maxLoadFactor;   // the ratio of elements to slots signifying a rehash
+   custom::vector<T> stash;     // the few elements no bucket could take
+};
+
+/************************************************
+ * CUCKOO SET ITERATOR
+ * Walks every slot of every bucket, then the stash
+ ************************************************/
+template <typename T, typename H, typename E, typename A>
+class cuckoo_set <T, H, E, A> ::iterator
+{
+   friend class ::TestCuckoo;   // give unit tests access to the privates
+   template <typename TT, typename HH, typename EE, typename AA>
+   friend class custom::cuckoo_set;
+public:
+   //
+   // Construct
+   //
+   iterator() : pSet(nullptr), i(0)
+   {
+   }
+   iterator(cuckoo_set* pSet, size_t i) : pSet(pSet), i(i)
+   {
+   }
+
+   //
+   // Compare
+   //
+   bool operator == (const iterator& rhs) const { return i == rhs.i; }
+   bool operator != (const iterator& rhs) const { return i != rhs.i; }
+
+   //
+   // Access
+   //
+   T& operator * ()  { return *get(); }
+   T* operator -> () { return get();  }
+
+   //
+   // Arithmetic
+   //
+   iterator& operator ++ ()
+   {
+      size_t numEnd = pSet->numBuckets * slotsPerBucket + pSet->stash.size();
+      do
+         ++i;
+      while (i < numEnd && !occupied());
+      return *this;
+   }
+   iterator operator ++ (int postfix)
+   {
+      iterator temp(*this);
+      ++(*this);
+      return temp;
+   }
+
+private:
+   bool occupied() const
+   {
+      size_t numSlots = pSet->numBuckets * slotsPerBucket;
+      if (i < numSlots)
+         return pSet->buckets[i / slotsPerBucket].tags[i % slotsPerBucket] != 0;
+      return i < numSlots + pSet->stash.size();
+   }
+   T* get() const
+   {
+      size_t numSlots = pSet->numBuckets * slotsPerBucket;
+      if (i < numSlots)
+         return pSet->buckets[i / slotsPerBucket].slot(i % slotsPerBucket);
+      return &pSet->stash[i - numSlots];
+   }
+
+   cuckoo_set* pSet;   // the set we walk
+   size_t i;           // slot number, counting on into the stash
+};
+
+/*****************************************
+ * CUCKOO SET :: COPY CONSTRUCTOR
+ * Same size table, every element in the same slot
+ ****************************************/
+template <typename T, typename H, typename E, typename A>
+cuckoo_set<T, H, E, A>::cuckoo_set(const cuckoo_set& rhs) :
+   buckets(nullptr), numBuckets(0), numElements(rhs.numElements),
+   maxLoadFactor(rhs.maxLoadFactor), stash(rhs.stash)
+{
+   allocate(rhs.numBuckets);
+   for (size_t b = 0; b < numBuckets; b++)
+      for (size_t s = 0; s < slotsPerBucket; s++)
+         if (rhs.buckets[b].tags[s])
+         {
+            Traits::construct(alloc, buckets[b].slot(s), *rhs.buckets[b].slot(s));
+            buckets[b].tags[s] = rhs.buckets[b].tags[s];
+         }
+}
+
+/*****************************************
+ * CUCKOO SET :: FIND
+ * Two buckets, then the stash if anything is there
+ ****************************************/
+template <typename T, typename H, typename E, typename A>
+typename cuckoo_set<T, H, E, A>::iterator cuckoo_set<T, H, E, A>::find(const T& t)
+{
+   size_t iBucket;
+   uint8_t tag;
+   locate(t, iBucket, tag);
+
+   iterator it = findIn(iBucket, tag, t);
+   if (it != end())
+      return it;
+   it = findIn(alternate(iBucket, tag), tag, t);
+   if (it != end())
+      return it;
+
+   for (size_t i = 0; i < stash.size(); i++)
+      if (E()(stash[i], t))
+         return iterator(this, numBuckets * slotsPerBucket + i);
+   return end();
+}
+
+/*****************************************
+ * CUCKOO SET :: FIND IN
+ * Look through one bucket. The tags are checked first
+ * so most misses never touch an element.
+ ****************************************/
+template <typename T, typename H, typename E, typename A>
+typename cuckoo_set<T, H, E, A>::iterator
+cuckoo_set<T, H, E, A>::findIn(size_t iBucket, uint8_t tag, const T& t)
+{
+   Bucket & bucket = buckets[iBucket];
+   for (size_t s = 0; s < slotsPerBucket; s++)
+      if (bucket.tags[s] == tag && E()(*bucket.slot(s), t))
+         return iterator(this, iBucket * slotsPerBucket + s);
+   return end();
+}
+
+/*****************************************
+ * CUCKOO SET :: INSERT
+ * Insert one element if it is not already here
+ ****************************************/
+template <typename T, typename H, typename E, typename A>
+custom::pair<typename cuckoo_set<T, H, E, A>::iterator, bool>
+cuckoo_set<T, H, E, A>::insert(const T& t)
+{
+   iterator it = find(t);
+   if (it != end())
+      return custom::pair<iterator, bool>(it, false);
+   T copy(t);
+   return custom::pair<iterator, bool>(insertNew(std::move(copy)), true);
+}
+template <typename T, typename H, typename E, typename A>
+custom::pair<typename cuckoo_set<T, H, E, A>::iterator, bool>
+cuckoo_set<T, H, E, A>::insert(T&& t)
+{
+   iterator it = find(t);
+   if (it != end())
+      return custom::pair<iterator, bool>(it, false);
+   return custom::pair<iterator, bool>(insertNew(std::move(t)), true);
+}
+
+/*****************************************
+ * CUCKOO SET :: INSERT NEW
+ * Add an element the caller knows is not already here:
+ * a free slot in either bucket, else a displacement
+ * chain, else the stash, else a bigger table.
+ * While rehashing, the element was already in the set,
+ * so the stash takes it rather than throwing half way
+ ****************************************/
+template <typename T, typename H, typename E, typename A>
+typename cuckoo_set<T, H, E, A>::iterator cuckoo_set<T, H, E, A>::insertNew(T&& t, bool rehashing)
+{
+   for (;;)
+   {
+      if ((float)(numElements + 1) > maxLoadFactor * (float)(numBuckets * slotsPerBucket))
+      {
+         rehash(numBuckets * 2);
+         continue;
+      }
+
+      size_t iFirst;
+      uint8_t tag;
+      locate(t, iFirst, tag);
+      size_t iSecond = alternate(iFirst, tag);
+
+      iterator it;
+      if (placeInBucket(iFirst, tag, std::move(t), it) ||
+          placeInBucket(iSecond, tag, std::move(t), it) ||
+          displace(iFirst, iSecond, tag, std::move(t), it))
+      {
+         numElements++;
+         return it;
+      }
+
+      if (stash.size() < stashCapacity || rehashing)
+      {
+         stash.push_back(std::move(t));
+         numElements++;
+         return iterator(this, numBuckets * slotsPerBucket + stash.size() - 1);
+      }
+
+      // A sparse table with no room for t all but surely means t
+      // shares its hash with everything in both its buckets and the
+      // stash. Doubling again would not split them up
+      if (load_factor() < 0.25f)
+         throw std::length_error("cuckoo_set: too many keys with one hash");
+      rehash(numBuckets * 2);
+   }
+}
+
+/*****************************************
+ * CUCKOO SET :: PLACE IN BUCKET
+ * Put t in a free slot of one bucket, if it has one
+ ****************************************/
+template <typename T, typename H, typename E, typename A>
+bool cuckoo_set<T, H, E, A>::placeInBucket(size_t iBucket, uint8_t tag, T&& t, iterator& it)
+{
+   Bucket & bucket = buckets[iBucket];
+   for (size_t s = 0; s < slotsPerBucket; s++)
+      if (bucket.tags[s] == 0)
+      {
+         Traits::construct(alloc, bucket.slot(s), std::move(t));
+         bucket.tags[s] = tag;
+         it = iterator(this, iBucket * slotsPerBucket + s);
+         return true;
+      }
+   return false;
+}
+
+/*****************************************
+ * CUCKOO SET :: DISPLACE
+ * Breadth-first search out from both buckets. Each
+ * step follows one element to its other bucket. The
+ * first bucket found with a free slot ends the
+ * shortest chain; then, from the far end back, each
+ * element in the chain moves into the slot freed
+ * ahead of it, and t takes the slot freed at the start.
+ ****************************************/
+template <typename T, typename H, typename E, typename A>
+bool cuckoo_set<T, H, E, A>::displace(size_t iFirst, size_t iSecond, uint8_t tag,
+                                      T&& t, iterator& it)
+{
+   Step steps[maxSearch];
+   size_t numSteps = 0;
+   steps[numSteps++] = Step{ iFirst,  -1, 0 };
+   steps[numSteps++] = Step{ iSecond, -1, 0 };
+
+   // Search for a bucket with a free slot
+   int found = -1;
+   size_t slotFree = 0;
+   for (size_t next = 0; next < numSteps && found < 0; next++)
+   {
+      Bucket & bucket = buckets[steps[next].iBucket];
+      for (size_t s = 0; s < slotsPerBucket && found < 0; s++)
+      {
+         size_t iAlt = alternate(steps[next].iBucket, bucket.tags[s]);
+
+         // Each bucket once, so no slot is on the chain twice
+         bool seen = false;
+         for (size_t k = 0; k < numSteps && !seen; k++)
+            seen = steps[k].iBucket == iAlt;
+         if (seen || numSteps == maxSearch)
+            continue;
+
+         steps[numSteps++] = Step{ iAlt, (int)next, s };
+         Bucket & alt = buckets[iAlt];
+         for (size_t f = 0; f < slotsPerBucket; f++)
+            if (alt.tags[f] == 0)
+            {
+               found = (int)numSteps - 1;
+               slotFree = f;
+               break;
+            }
+      }
+   }
+   if (found < 0)
+      return false;
+
+   // Shift the chain toward the free slot, far end first
+   int k = found;
+   while (steps[k].parent >= 0)
+   {
+      Bucket & to   = buckets[steps[k].iBucket];
+      Bucket & from = buckets[steps[steps[k].parent].iBucket];
+      size_t s = steps[k].slotFrom;
+      Traits::construct(alloc, to.slot(slotFree), std::move(*from.slot(s)));
+      to.tags[slotFree] = from.tags[s];
+      Traits::destroy(alloc, from.slot(s));
+      from.tags[s] = 0;
+      slotFree = s;
+      k = steps[k].parent;
+   }
+
+   // The start of the chain now has room for t
+   Bucket & bucket = buckets[steps[k].iBucket];
+   Traits::construct(alloc, bucket.slot(slotFree), std::move(t));
+   bucket.tags[slotFree] = tag;
+   it = iterator(this, steps[k].iBucket * slotsPerBucket + slotFree);
+   return true;
+}
+
+/*****************************************
+ * CUCKOO SET :: ERASE
+ * Remove one element. In the stash, the last element
+ * fills the hole.
+ ****************************************/
+template <typename T, typename H, typename E, typename A>
+typename cuckoo_set<T, H, E, A>::iterator cuckoo_set<T, H, E, A>::erase(const T& t)
+{
+   return erase(find(t));
+}
+template <typename T, typename H, typename E, typename A>
+typename cuckoo_set<T, H, E, A>::iterator cuckoo_set<T, H, E, A>::erase(const iterator& it)
+{
+   if (it == end())
+      return it;
+
+   size_t numSlots = numBuckets * slotsPerBucket;
+   iterator itNext(this, it.i);
+   if (it.i < numSlots)
+   {
+      Bucket & bucket = buckets[it.i / slotsPerBucket];
+      Traits::destroy(alloc, bucket.slot(it.i % slotsPerBucket));
+      bucket.tags[it.i % slotsPerBucket] = 0;
+      ++itNext;
+   }
+   else
+   {
+      size_t iStash = it.i - numSlots;
+      if (iStash + 1 != stash.size())
+         stash[iStash] = std::move(stash.back());
+      stash.pop_back();
+   }
+   numElements--;
+   return itNext;
+}
+
+/*****************************************
+ * CUCKOO SET :: CLEAR
+ * Destroy every element but keep the buckets
+ ****************************************/
+template <typename T, typename H, typename E, typename A>
+void cuckoo_set<T, H, E, A>::clear() noexcept
+{
+   for (size_t b = 0; b < numBuckets; b++)
+      for (size_t s = 0; s < slotsPerBucket; s++)
+         if (buckets[b].tags[s])
+         {
+            Traits::destroy(alloc, buckets[b].slot(s));
+            buckets[b].tags[s] = 0;
+         }
+   stash.clear();
+   numElements = 0;
+}
+
+/*****************************************
+ * CUCKOO SET :: REHASH
+ * Grow to at least numBuckets buckets and put every
+ * element, stash included, in its new place
+ ****************************************/
+template <typename T, typename H, typename E, typename A>
+void cuckoo_set<T, H, E, A>::rehash(size_t numBuckets)
+{
+   // If already more buckets, return
+   if (numBuckets <= bucket_count())
+      return;
+
+   // Take the old buckets and stash aside and start over with empty ones
+   Bucket * bucketsOld = buckets;
+   size_t numBucketsOld = this->numBuckets;
+   custom::vector<T> stashOld;
+   stashOld.swap(stash);
+   allocate(roundUp(numBuckets));
+   numElements = 0;
+
+   // Move each element across. If one does not fit, insertNew
+   // grows again, which moves what is here so far along.
+   for (size_t b = 0; b < numBucketsOld; b++)
+      for (size_t s = 0; s < slotsPerBucket; s++)
+         if (bucketsOld[b].tags[s])
+         {
+            insertNew(std::move(*bucketsOld[b].slot(s)), true /*rehashing*/);
+            Traits::destroy(alloc, bucketsOld[b].slot(s));
+         }
+   for (size_t i = 0; i < stashOld.size(); i++)
+      insertNew(std::move(stashOld[i]), true /*rehashing*/);
+
+   for (size_t b = 0; b < numBucketsOld; b++)
+      BucketTraits::destroy(bucketAlloc, bucketsOld + b);
+   BucketTraits::deallocate(bucketAlloc, bucketsOld, numBucketsOld);
+}
+
+/*****************************************
+ * CUCKOO SET :: ALLOCATE and DEALLOCATE
+ * Get numBuckets empty buckets
+ ****************************************/
+template <typename T, typename H, typename E, typename A>
+void cuckoo_set<T, H, E, A>::allocate(size_t numBuckets)
+{
+   buckets = BucketTraits::allocate(bucketAlloc, numBuckets);
+   for (size_t b = 0; b < numBuckets; b++)
+      BucketTraits::construct(bucketAlloc, buckets + b);
+   this->numBuckets = numBuckets;
+}
+template <typename T, typename H, typename E, typename A>
+void cuckoo_set<T, H, E, A>::deallocate()
+{
+   if (buckets == nullptr)
+      return;
+   for (size_t b = 0; b < numBuckets; b++)
+      BucketTraits::destroy(bucketAlloc, buckets + b);
+   BucketTraits::deallocate(bucketAlloc, buckets, numBuckets);
+   buckets = nullptr;
+}
+
+/*****************************************
+ * SWAP
+ * Stand-alone cuckoo set swap
+ ****************************************/
+template <typename T, typename H, typename E, typename A>
+void swap(cuckoo_set<T, H, E, A>& lhs, cuckoo_set<T, H, E, A>& rhs)
+{
+   lhs.swap(rhs);
+}
+
+}
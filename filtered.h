@@ -0,0 +1,230 @@
+/***********************************************************************
+ * Header:
+ *    FILTERED
+ * Summary:
+ *    A set or map with a Bloom filter in front of its lookups
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        filtered_set : An unordered_set whose misses rarely reach it
+ *        filtered_map : A map whose misses rarely reach it
+ * Author
+ *    Tyler and Braeden
+ ************************************************************************/
+
+#pragma once
+
+#include "pair.h"          // for pair
+#include "bloom_filter.h"  // the filter in front
+#include "hash.h"          // the default set behind it
+#include "map.h"           // the default map behind it
+#include <stdexcept>       // for std::out_of_range
+
+class TestFiltered;         // forward declaration for unit tests
+
+namespace custom
+{
+
+/************************************************
+ * FILTERED SET
+ * Every key inserted also goes in the filter, so a key
+ * the filter has never seen is answered without going
+ * near the buckets. Built for lookups that mostly miss.
+ * With a plain bloom_filter, erased keys stay in the
+ * filter and only cost a wasted probe; rebuild() clears
+ * them out. A counting_bloom_filter forgets them at once.
+ ************************************************/
+template <typename T,
+          typename Hash = std::hash<T>,
+          typename Filter = bloom_filter<T, Hash>,
+          typename Set = unordered_set<T, Hash> >
+class filtered_set
+{
+   friend class ::TestFiltered;   // give unit tests access to the privates
+public:
+   using iterator = typename Set::iterator;
+
+   //
+   // Construct
+   //
+   filtered_set(size_t numExpected = 1024, double falsePositiveRate = 0.01) :
+      filter(numExpected, falsePositiveRate)
+   {
+   }
+
+   //
+   // Iterator
+   //
+   iterator begin() { return set.begin(); }
+   iterator end()   { return set.end();   }
+
+   //
+   // Access
+   //
+   iterator find(const T& t)
+   {
+      return filter.contains(t) ? set.find(t) : set.end();
+   }
+   size_t count(const T& t)
+   {
+      return find(t) == end() ? 0 : 1;
+   }
+
+   //
+   // Insert
+   //
+   custom::pair<iterator, bool> insert(const T& t)
+   {
+      auto result = set.insert(t);
+      if (result.second)
+         filter.insert(t);
+      return result;
+   }
+
+   //
+   // Remove
+   //
+   size_t erase(const T& t)
+   {
+      iterator it = find(t);
+      if (it == end())
+         return 0;
+      if constexpr (Filter::can_erase)
+         filter.erase(t);
+      set.erase(t);
+      return 1;
+   }
+   void clear()
+   {
+      set.clear();
+      filter.clear();
+   }
+
+   // Start a new filter sized for numExpected from what is in the set
+   void rebuild(size_t numExpected, double falsePositiveRate = 0.01)
+   {
+      filter = Filter(numExpected, falsePositiveRate);
+      for (iterator it = set.begin(); it != set.end(); ++it)
+         filter.insert(*it);
+   }
+
+   //
+   // Status
+   //
+   size_t size() const { return set.size();  }
+   bool empty() const  { return set.empty(); }
+
+private:
+   Filter filter;   // every key in the set, and maybe some that were
+   Set    set;      // the elements
+};
+
+/************************************************
+ * FILTERED MAP
+ * The same for key/value lookups: the keys go in the
+ * filter, and find() and at() only walk the tree when
+ * the filter says the key might be there.
+ ************************************************/
+template <typename K,
+          typename V,
+          typename Hash = std::hash<K>,
+          typename Filter = bloom_filter<K, Hash>,
+          typename Map = map<K, V> >
+class filtered_map
+{
+   friend class ::TestFiltered;   // give unit tests access to the privates
+public:
+   using iterator = typename Map::iterator;
+   using Pairs = custom::pair<K, V>;
+
+   //
+   // Construct
+   //
+   filtered_map(size_t numExpected = 1024, double falsePositiveRate = 0.01) :
+      filter(numExpected, falsePositiveRate)
+   {
+   }
+
+   //
+   // Iterator
+   //
+   iterator begin() { return m.begin(); }
+   iterator end()   { return m.end();   }
+
+   //
+   // Access
+   //
+   iterator find(const K& k)
+   {
+      return filter.contains(k) ? m.find(k) : m.end();
+   }
+   size_t count(const K& k)
+   {
+      return find(k) == end() ? 0 : 1;
+   }
+   V& at(const K& k)
+   {
+      if (!filter.contains(k))
+         throw std::out_of_range("invalid filtered_map<K, T> key");
+      return m.at(k);
+   }
+   V& operator [] (const K& k)
+   {
+      if (find(k) == end())
+         filter.insert(k);
+      return m[k];
+   }
+
+   //
+   // Insert
+   //
+   custom::pair<iterator, bool> insert(const Pairs& rhs)
+   {
+      auto result = m.insert(rhs);
+      if (result.second)
+         filter.insert(rhs.first);
+      return result;
+   }
+
+   //
+   // Remove
+   //
+   size_t erase(const K& k)
+   {
+      if (find(k) == end())
+         return 0;
+      if constexpr (Filter::can_erase)
+         filter.erase(k);
+      return m.erase(k);
+   }
+   void clear()
+   {
+      m.clear();
+      filter.clear();
+   }
+
+   // Start a new filter sized for numExpected from what is in the map
+   void rebuild(size_t numExpected, double falsePositiveRate = 0.01)
+   {
+      filter = Filter(numExpected, falsePositiveRate);
+      for (iterator it = m.begin(); it != m.end(); ++it)
+         filter.insert((*it).first);
+   }
+
+   //
+   // Status
+   //
+   size_t size() const { return m.size();  }
+   bool empty() const  { return m.empty(); }
+
+private:
+   Filter filter;   // every key in the map, and maybe some that were
+   Map    m;        // the pairs
+};
+
+}
@@ -0,0 +1,442 @@
+/***********************************************************************
+ * Header:
+ *    FLAT MAP
+ * Summary:
+ *    A map kept as two sorted, parallel vectors
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        flat_map            : A map stored as sorted keys beside their values
+ *        flat_map::iterator  : An iterator through a flat_map
+ * Author
+ *    Tyler and Braeden
+ ************************************************************************/
+
+#pragma once
+
+#include "pair.h"       // for pair
+#include "flat_set.h"   // for flat_lower_bound
+#include "vector.h"     // the keys and values live in vectors
+#include <algorithm>    // for std::stable_sort and std::rotate
+#include <functional>   // for std::less
+#include <stdexcept>    // for std::out_of_range
+#include <string>       // for std::string
+
+class TestFlatMap;       // forward declaration for unit tests
+
+namespace custom
+{
+
+/************************************************
+ * FLAT MAP
+ * The same interface as map, minus node handles.
+ * The keys are sorted in one vector and each value
+ * sits at the same index in another, so a lookup
+ * binary searches nothing but keys, packed tight,
+ * and only touches the value it finds. There are
+ * no nodes, so no pointers or allocation per entry.
+ * Because the pair is never stored whole, an
+ * iterator hands back a reference proxy with
+ * first and second rather than a pair.
+ ************************************************/
+template <typename K, typename V, typename Compare = std::less<K>>
+class flat_map
+{
+   friend class ::TestFlatMap;   // give unit tests access to the privates
+public:
+   using Pairs = custom::pair<K, V>;
+
+   // What *it gives back: the key and its value, by reference
+   struct reference
+   {
+      const K& first;
+      V&       second;
+   };
+
+   //
+   // Construct
+   //
+   flat_map()
+   {
+   }
+   flat_map(const flat_map& rhs) : keys(rhs.keys), values(rhs.values)
+   {
+   }
+   flat_map(flat_map&& rhs) : keys(std::move(rhs.keys)), values(std::move(rhs.values))
+   {
+   }
+   template <class Iterator>
+   flat_map(Iterator first, Iterator last)
+   {
+      insert(first, last);
+   }
+   flat_map(const std::initializer_list <Pairs>& il)
+   {
+      insert(il.begin(), il.end());
+   }
+
+   //
+   // Assign
+   //
+   flat_map& operator = (const flat_map& rhs)
+   {
+      keys = rhs.keys;
+      values = rhs.values;
+      return *this;
+   }
+   flat_map& operator = (flat_map&& rhs)
+   {
+      keys = std::move(rhs.keys);
+      values = std::move(rhs.values);
+      return *this;
+   }
+   flat_map& operator = (const std::initializer_list <Pairs>& il)
+   {
+      clear();
+      insert(il.begin(), il.end());
+      return *this;
+   }
+   void swap(flat_map& rhs) noexcept
+   {
+      keys.swap(rhs.keys);
+      values.swap(rhs.values);
+   }
+
+   //
+   // Iterator
+   //
+   class iterator;
+   iterator begin()
+   {
+      return iterator(firstKey(), firstValue());
+   }
+   iterator end()
+   {
+      return iterator(firstKey() + keys.size(), firstValue() + values.size());
+   }
+
+   //
+   // Access
+   //
+   V& operator [] (const K& k);
+   V& at(const K& k)
+   {
+      size_t i = indexOf(k);
+      if (i == keys.size())
+         throw std::out_of_range(std::string("invalid flat_map<K, T> key"));
+      return values[i];
+   }
+   const V& at(const K& k) const
+   {
+      size_t i = indexOf(k);
+      if (i == keys.size())
+         throw std::out_of_range(std::string("invalid flat_map<K, T> key"));
+      return values[i];
+   }
+   iterator find(const K& k)
+   {
+      return iteratorAt(indexOf(k));
+   }
+   iterator lower_bound(const K& k)
+   {
+      return iteratorAt(lowerBound(k));
+   }
+   size_t count(const K& k) const
+   {
+      return indexOf(k) == keys.size() ? 0 : 1;
+   }
+
+   //
+   // Insert
+   //
+   custom::pair<iterator, bool> insert(Pairs&& rhs)
+   {
+      return emplace(std::move(rhs.first), std::move(rhs.second));
+   }
+   custom::pair<iterator, bool> insert(const Pairs& rhs)
+   {
+      return emplace(K(rhs.first), V(rhs.second));
+   }
+   template <class Iterator>
+   void insert(Iterator first, Iterator last);
+   void insert(const std::initializer_list <Pairs>& il)
+   {
+      insert(il.begin(), il.end());
+   }
+   void reserve(size_t numElements)
+   {
+      keys.reserve(numElements);
+      values.reserve(numElements);
+   }
+
+   //
+   // Remove
+   //
+   void clear() noexcept
+   {
+      keys.clear();
+      values.clear();
+   }
+   size_t erase(const K& k)
+   {
+      size_t i = indexOf(k);
+      if (i == keys.size())
+         return 0;
+      eraseRange(i, i + 1);
+      return 1;
+   }
+   iterator erase(iterator it)
+   {
+      size_t i = it.pKey - firstKey();
+      return eraseRange(i, i + 1);
+   }
+   iterator erase(iterator first, iterator last)
+   {
+      return eraseRange(first.pKey - firstKey(), last.pKey - firstKey());
+   }
+
+   //
+   // Status
+   //
+   bool empty() const noexcept
+   {
+      return keys.empty();
+   }
+   size_t size() const noexcept
+   {
+      return keys.size();
+   }
+
+private:
+   // The first key or value, or null when there are none
+   K* firstKey() const
+   {
+      return keys.empty() ? nullptr : const_cast<K*>(&keys[0]);
+   }
+   V* firstValue() const
+   {
+      return values.empty() ? nullptr : const_cast<V*>(&values[0]);
+   }
+   iterator iteratorAt(size_t i)
+   {
+      return iterator(firstKey() + i, firstValue() + i);
+   }
+
+   size_t lowerBound(const K& k) const
+   {
+      return flat_lower_bound(firstKey(), keys.size(), k, comp);
+   }
+   // The index of k, or size() if it is not here
+   size_t indexOf(const K& k) const
+   {
+      size_t i = lowerBound(k);
+      return (i != keys.size() && !comp(k, keys[i])) ? i : keys.size();
+   }
+
+   custom::pair<iterator, bool> emplace(K&& k, V&& v);
+   iterator eraseRange(size_t iBegin, size_t iEnd);
+
+   custom::vector<K> keys;     // sorted, no two equal
+   custom::vector<V> values;   // values[i] belongs to keys[i]
+   Compare comp;               // the ordering of the keys
+};
+
+/**********************************************************
+ * FLAT MAP ITERATOR
+ * A key pointer and a value pointer that move in step
+ *********************************************************/
+template <typename K, typename V, typename Compare>
+class flat_map <K, V, Compare> :: iterator
+{
+   friend class ::TestFlatMap;   // give unit tests access to the privates
+   friend class flat_map;
+public:
+   //
+   // Construct
+   //
+   iterator() : pKey(nullptr), pValue(nullptr)
+   {
+   }
+   iterator(K* pKey, V* pValue) : pKey(pKey), pValue(pValue)
+   {
+   }
+   iterator(const iterator& rhs) : pKey(rhs.pKey), pValue(rhs.pValue)
+   {
+   }
+
+   //
+   // Assign
+   //
+   iterator& operator = (const iterator& rhs)
+   {
+      pKey = rhs.pKey;
+      pValue = rhs.pValue;
+      return *this;
+   }
+
+   //
+   // Compare
+   //
+   bool operator == (const iterator& rhs) const
+   {
+      return pKey == rhs.pKey;
+   }
+   bool operator != (const iterator& rhs) const
+   {
+      return pKey != rhs.pKey;
+   }
+
+   //
+   // Access
+   //
+   reference operator * () const
+   {
+      return reference{ *pKey, *pValue };
+   }
+
+   //
+   // Increment
+   //
+   iterator& operator ++ ()
+   {
+      ++pKey;
+      ++pValue;
+      return *this;
+   }
+   iterator operator ++ (int postfix)
+   {
+      iterator old(*this);
+      ++*this;
+      return old;
+   }
+   iterator& operator -- ()
+   {
+      --pKey;
+      --pValue;
+      return *this;
+   }
+   iterator operator -- (int postfix)
+   {
+      iterator old(*this);
+      --*this;
+      return old;
+   }
+
+private:
+   K* pKey;
+   V* pValue;
+};
+
+/*****************************************************
+ * FLAT MAP :: SUBSCRIPT
+ * The value for key, put in with V() if it is new
+ ****************************************************/
+template <typename K, typename V, typename Compare>
+V& flat_map <K, V, Compare> :: operator [] (const K& key)
+{
+   size_t i = indexOf(key);
+   if (i != keys.size())
+      return values[i];
+   return (*emplace(K(key), V()).first).second;
+}
+
+/*****************************************************
+ * FLAT MAP :: EMPLACE
+ * Put k and v at their sorted place, moving every
+ * later key and value up one
+ ****************************************************/
+template <typename K, typename V, typename Compare>
+custom::pair<typename flat_map<K, V, Compare>::iterator, bool>
+flat_map<K, V, Compare>::emplace(K&& k, V&& v)
+{
+   size_t i = lowerBound(k);
+   if (i != keys.size() && !comp(k, keys[i]))
+      return custom::pair<iterator, bool>(iteratorAt(i), false);
+
+   keys.push_back(std::move(k));
+   values.push_back(std::move(v));
+   size_t n = keys.size();
+   std::rotate(firstKey() + i, firstKey() + n - 1, firstKey() + n);
+   std::rotate(firstValue() + i, firstValue() + n - 1, firstValue() + n);
+   return custom::pair<iterator, bool>(iteratorAt(i), true);
+}
+
+/*****************************************************
+ * FLAT MAP :: INSERT RANGE
+ * Sort the new keys on their own (by index, so the
+ * values come along) and merge them with the old ones
+ * in one pass into new vectors. A key already here
+ * keeps its value, as does the first of any repeats
+ * in the range: the same as map's one-at-a-time insert,
+ * but O(m log m + n) rather than O(m n).
+ ****************************************************/
+template <typename K, typename V, typename Compare>
+template <class Iterator>
+void flat_map<K, V, Compare>::insert(Iterator first, Iterator last)
+{
+   size_t numOld = keys.size();
+   for (; first != last; ++first)
+   {
+      keys.push_back((*first).first);
+      values.push_back((*first).second);
+   }
+   size_t numNew = keys.size() - numOld;
+   if (numNew == 0)
+      return;
+
+   // The new entries in key order, the earliest first among equals
+   custom::vector<size_t> order(numNew);
+   for (size_t i = 0; i < numNew; i++)
+      order[i] = numOld + i;
+   const K* pKeys = firstKey();
+   std::stable_sort(&order[0], &order[0] + numNew,
+                    [&](size_t lhs, size_t rhs) { return comp(pKeys[lhs], pKeys[rhs]); });
+
+   // Merge, old first on a tie, skipping any key equal to the last one kept
+   custom::vector<K> keysMerged;
+   custom::vector<V> valuesMerged;
+   keysMerged.reserve(keys.size());
+   valuesMerged.reserve(keys.size());
+   size_t iOld = 0;
+   size_t iNew = 0;
+   while (iOld < numOld || iNew < numNew)
+   {
+      size_t i = (iNew == numNew || (iOld < numOld && !comp(keys[order[iNew]], keys[iOld])))
+               ? iOld++ : order[iNew++];
+      if (keysMerged.empty() || comp(keysMerged.back(), keys[i]))
+      {
+         keysMerged.push_back(std::move(keys[i]));
+         valuesMerged.push_back(std::move(values[i]));
+      }
+   }
+   keys.swap(keysMerged);
+   values.swap(valuesMerged);
+}
+
+/*****************************************************
+ * FLAT MAP :: ERASE RANGE
+ * Close the gap left by [iBegin, iEnd) in both vectors
+ ****************************************************/
+template <typename K, typename V, typename Compare>
+typename flat_map<K, V, Compare>::iterator
+flat_map<K, V, Compare>::eraseRange(size_t iBegin, size_t iEnd)
+{
+   if (iBegin == iEnd)
+      return iteratorAt(iBegin);
+   size_t n = keys.size();
+   std::move(firstKey() + iEnd, firstKey() + n, firstKey() + iBegin);
+   std::move(firstValue() + iEnd, firstValue() + n, firstValue() + iBegin);
+   for (size_t i = iBegin; i < iEnd; i++)
+   {
+      keys.pop_back();
+      values.pop_back();
+   }
+   return iteratorAt(iBegin);
+}
+
+}
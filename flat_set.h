@@ -0,0 +1,355 @@
+/***********************************************************************
+ * Header:
+ *    FLAT SET
+ * Summary:
+ *    A set kept as one sorted vector
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        flat_set            : A set stored as a sorted vector
+ *        flat_set::iterator  : An iterator through a flat_set
+ * Author
+ *    Tyler and Braeden
+ ************************************************************************/
+
+#pragma once
+
+#include "vector.h"    // the elements live in a vector
+#include <algorithm>   // for std::stable_sort, std::inplace_merge and std::rotate
+#include <functional>  // for std::less
+#include <utility>     // for std::pair and std::move
+
+class TestFlatSet;      // forward declaration for unit tests
+
+namespace custom
+{
+
+/************************************************
+ * FLAT LOWER BOUND
+ * The first index in the sorted array a[0, n) that is
+ * not less than t. The loop runs log2(n) times no matter
+ * what the keys are, and each step is a conditional move
+ * rather than a branch, so it does not mispredict.
+ ************************************************/
+template <typename T, typename Key, typename Compare>
+size_t flat_lower_bound(const T* a, size_t n, const Key& t, const Compare& comp)
+{
+   if (n == 0)
+      return 0;
+   const T* base = a;
+   while (n > 1)
+   {
+      size_t half = n / 2;
+      base = comp(base[half - 1], t) ? base + half : base;
+      n -= half;
+   }
+   return (size_t)(base - a) + comp(*base, t);
+}
+
+/************************************************
+ * FLAT SET
+ * The same interface as set, but the elements sit
+ * sorted and side by side in one vector rather than
+ * one node each. Lookups are a binary search over
+ * contiguous memory; a single insert or erase shifts
+ * everything after it, so build it with the range
+ * insert and then read it.
+ ************************************************/
+template <typename T, typename Compare = std::less<T>>
+class flat_set
+{
+   friend class ::TestFlatSet;   // give unit tests access to the privates
+public:
+
+   //
+   // Construct
+   //
+   flat_set()
+   {
+   }
+   flat_set(const flat_set& rhs) : elements(rhs.elements)
+   {
+   }
+   flat_set(flat_set&& rhs) : elements(std::move(rhs.elements))
+   {
+   }
+   flat_set(const std::initializer_list <T>& il)
+   {
+      insert(il.begin(), il.end());
+   }
+   template <class Iterator>
+   flat_set(Iterator first, Iterator last)
+   {
+      insert(first, last);
+   }
+
+   //
+   // Assign
+   //
+   flat_set& operator = (const flat_set& rhs)
+   {
+      elements = rhs.elements;
+      return *this;
+   }
+   flat_set& operator = (flat_set&& rhs)
+   {
+      elements = std::move(rhs.elements);
+      return *this;
+   }
+   flat_set& operator = (const std::initializer_list <T>& il)
+   {
+      clear();
+      insert(il.begin(), il.end());
+      return *this;
+   }
+   void swap(flat_set& rhs) noexcept
+   {
+      elements.swap(rhs.elements);
+   }
+
+   //
+   // Iterator
+   //
+   class iterator;
+   iterator begin() const noexcept
+   {
+      return iterator(first());
+   }
+   iterator end() const noexcept
+   {
+      return iterator(first() + elements.size());
+   }
+
+   //
+   // Access
+   //
+   iterator find(const T& t) const
+   {
+      size_t i = lowerBound(t);
+      return (i != elements.size() && !comp(t, elements[i])) ? iterator(first() + i) : end();
+   }
+   iterator lower_bound(const T& t) const
+   {
+      return iterator(first() + lowerBound(t));
+   }
+   size_t count(const T& t) const
+   {
+      return find(t) == end() ? 0 : 1;
+   }
+
+   //
+   // Status
+   //
+   bool empty() const noexcept
+   {
+      return elements.empty();
+   }
+   size_t size() const noexcept
+   {
+      return elements.size();
+   }
+
+   //
+   // Insert
+   //
+   std::pair<iterator, bool> insert(const T& t)
+   {
+      T copy(t);
+      return insert(std::move(copy));
+   }
+   std::pair<iterator, bool> insert(T&& t);
+   void insert(const std::initializer_list <T>& il)
+   {
+      insert(il.begin(), il.end());
+   }
+   template <class Iterator>
+   void insert(Iterator first, Iterator last);
+   void reserve(size_t numElements)
+   {
+      elements.reserve(numElements);
+   }
+
+   //
+   // Remove
+   //
+   void clear() noexcept
+   {
+      elements.clear();
+   }
+   iterator erase(iterator& it);
+   iterator erase(iterator& itBegin, iterator& itEnd);
+   size_t erase(const T& t)
+   {
+      iterator it = find(t);
+      if (it == end())
+         return 0;
+      erase(it);
+      return 1;
+   }
+
+private:
+   // The first element, or null when there are none
+   T* first() const
+   {
+      return elements.empty() ? nullptr : const_cast<T*>(&elements[0]);
+   }
+   size_t lowerBound(const T& t) const
+   {
+      return flat_lower_bound(first(), elements.size(), t, comp);
+   }
+
+   custom::vector<T> elements;   // sorted, no two equal
+   Compare comp;                 // the ordering
+};
+
+/**************************************************
+ * FLAT SET ITERATOR
+ * A pointer into the sorted elements. Like set,
+ * the elements are read only: changing one could
+ * put it out of order.
+ *************************************************/
+template <typename T, typename Compare>
+class flat_set <T, Compare> :: iterator
+{
+   friend class ::TestFlatSet;   // give unit tests access to the privates
+   friend class flat_set;
+public:
+   // constructors, destructors, and assignment operator
+   iterator()                    : p(nullptr) { }
+   iterator(T* p)                : p(p)       { }
+   iterator(const iterator& rhs) : p(rhs.p)   { }
+   iterator& operator = (const iterator& rhs)
+   {
+      p = rhs.p;
+      return *this;
+   }
+
+   // equals, not equals operator
+   bool operator != (const iterator& rhs) const { return p != rhs.p; }
+   bool operator == (const iterator& rhs) const { return p == rhs.p; }
+
+   // dereference operator
+   const T& operator * () const { return *p; }
+
+   // increment and decrement
+   iterator& operator ++ ()
+   {
+      ++p;
+      return *this;
+   }
+   iterator operator ++ (int postfix)
+   {
+      iterator old(*this);
+      ++p;
+      return old;
+   }
+   iterator& operator -- ()
+   {
+      --p;
+      return *this;
+   }
+   iterator operator -- (int postfix)
+   {
+      iterator old(*this);
+      --p;
+      return old;
+   }
+
+private:
+   T* p;
+};
+
+/*****************************************
+ * FLAT SET :: INSERT
+ * Put t in its sorted place, moving everything
+ * after it up one
+ ****************************************/
+template <typename T, typename Compare>
+std::pair<typename flat_set<T, Compare>::iterator, bool>
+flat_set<T, Compare>::insert(T&& t)
+{
+   size_t i = lowerBound(t);
+   if (i != elements.size() && !comp(t, elements[i]))
+      return std::pair<iterator, bool>(iterator(first() + i), false);
+
+   elements.push_back(std::move(t));
+   T* p = first();
+   std::rotate(p + i, p + elements.size() - 1, p + elements.size());
+   return std::pair<iterator, bool>(iterator(p + i), true);
+}
+
+/*****************************************
+ * FLAT SET :: INSERT RANGE
+ * Append the new elements, sort just those, and
+ * merge them into the old ones in one pass. Then
+ * squeeze out duplicates, keeping the first of each.
+ * O(m log m + n) for m new elements, rather than
+ * the O(m n) of inserting them one at a time.
+ ****************************************/
+template <typename T, typename Compare>
+template <class Iterator>
+void flat_set<T, Compare>::insert(Iterator itFirst, Iterator itLast)
+{
+   size_t numOld = elements.size();
+   for (; itFirst != itLast; ++itFirst)
+      elements.push_back(*itFirst);
+   if (elements.size() == numOld)
+      return;
+
+   T* p = first();
+   T* pEnd = p + elements.size();
+   std::stable_sort(p + numOld, pEnd, comp);
+   std::inplace_merge(p, p + numOld, pEnd, comp);
+
+   // Sorted, so equal elements are next to each other
+   size_t numKeep = 1;
+   for (size_t i = 1; i < elements.size(); i++)
+      if (comp(p[numKeep - 1], p[i]))
+      {
+         if (i != numKeep)
+            p[numKeep] = std::move(p[i]);
+         numKeep++;
+      }
+   while (elements.size() > numKeep)
+      elements.pop_back();
+}
+
+/*****************************************
+ * FLAT SET :: ERASE
+ * Close the gap and return the next element
+ ****************************************/
+template <typename T, typename Compare>
+typename flat_set<T, Compare>::iterator flat_set<T, Compare>::erase(iterator& it)
+{
+   T* p = first();
+   size_t i = it.p - p;
+   std::move(p + i + 1, p + elements.size(), p + i);
+   elements.pop_back();
+   return iterator(first() + i);
+}
+
+/*****************************************
+ * FLAT SET :: ERASE RANGE
+ * Close the gap left by [itBegin, itEnd) in one pass
+ ****************************************/
+template <typename T, typename Compare>
+typename flat_set<T, Compare>::iterator
+flat_set<T, Compare>::erase(iterator& itBegin, iterator& itEnd)
+{
+   if (itBegin == itEnd)
+      return itEnd;
+   T* p = first();
+   size_t i = itBegin.p - p;
+   size_t numErase = itEnd.p - itBegin.p;
+   std::move(itEnd.p, p + elements.size(), itBegin.p);
+   for (size_t n = 0; n < numErase; n++)
+      elements.pop_back();
+   return iterator(first() + i);
+}
+
+}
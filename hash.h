@@ -30,6 +30,9 @@ class TestHash;             // forward declaration for Hash unit tests
 
 namespace custom
 {
+template <typename K, typename V, typename Hash, typename EqPred, typename A>
+class unordered_map;        // shares our buckets, so it needs the privates
+
 /************************************************
  * UNORDERED SET
  * A set implemented as a hash
@@ -41,6 +44,8 @@ template <typename T,
 class unordered_set
 {
    friend class ::TestHash;   // give unit tests access to the privates
+   template <typename KK, typename VV, typename HH, typename EE, typename AA>
+   friend class custom::unordered_map;
 public:
    //
    // Construct
@@ -140,12 +145,16 @@ public:
    {
       return Hash()(t) % bucket_count();
    }
-   iterator find(const T& t);
+   iterator find(const T& t)
+   {
+      return findKey(t);
+   }
 
    //   
    // Insert
    //
    custom::pair<iterator, bool> insert(const T& t);
+   custom::pair<iterator, bool> insert(T&& t);
    void insert(const std::initializer_list<T> & il);
    void rehash(size_t numBuckets);
    void reserve(size_t num)
@@ -163,6 +172,16 @@ public:
       numElements = 0;
    }
    iterator erase(const T& t);
+   iterator erase(const iterator& it);
+
+   //
+   // Node Handles
+   //
+   class node_type;
+   node_type extract(const T& t);
+   node_type extract(const iterator& it);
+   custom::pair<iterator, bool> insert(node_type&& nh);
+   void merge(unordered_set& rhs);
 
    //
    // Status
@@ -204,6 +223,10 @@ private:
       return (size_t)std::ceil(num / maxLoadFactor);
    }
 
+   template <class Key>
+   iterator findKey(const Key& key);
+   iterator insertNew(T&& t);
+
    custom::vector<custom::list<T,A>> buckets;  // each bucket in the hash
    int numElements;                            // number of elements in the Hash
    float maxLoadFactor;                        // the ratio of elements to buckets signifying a rehash
@@ -366,6 +389,55 @@ private:
 };
 
 
+/************************************************
+ * UNORDERED SET NODE HANDLE
+ * Owns one element taken out of an unordered set. The
+ * element stays in its list node, which is spliced
+ * between buckets rather than reallocated.
+ ************************************************/
+template <typename T, typename H, typename E, typename A>
+class unordered_set <T, H, E, A> ::node_type
+{
+   friend class ::TestHash;   // give unit tests access to the privates
+   template <typename TT, typename HH, typename EE, typename AA>
+   friend class custom::unordered_set;
+public:
+   //
+   // Construct
+   //
+   node_type()
+   {
+   }
+   node_type(node_type&& rhs) : node(std::move(rhs.node))
+   {
+   }
+
+   //
+   // Assign
+   //
+   node_type& operator = (node_type&& rhs)
+   {
+      node = std::move(rhs.node);
+      return *this;
+   }
+
+   //
+   // Access
+   //
+   bool empty() const
+   {
+      return node.empty();
+   }
+   T& value()
+   {
+      return node.front();
+   }
+
+private:
+   custom::list<T, A> node;   // holds at most one node
+};
+
+
 /*****************************************
  * UNORDERED SET :: ERASE
  * Remove one element from the unordered set
@@ -373,9 +445,16 @@ private:
 template <typename T, typename Hash, typename E, typename A>
 typename unordered_set <T, Hash, E, A> ::iterator unordered_set<T,Hash,E,A>::erase(const T& t)
 {
-   // Find the element to erase
-   auto itErase = find(t);
-   
+   return erase(find(t));
+}
+
+/*****************************************
+ * UNORDERED SET :: ERASE
+ * Remove the element at an iterator
+ ****************************************/
+template <typename T, typename Hash, typename E, typename A>
+typename unordered_set <T, Hash, E, A> ::iterator unordered_set<T,Hash,E,A>::erase(const iterator& itErase)
+{
    // If it doesnt exist return
    if (itErase == end())
       return itErase;
@@ -385,7 +464,8 @@ typename unordered_set <T, Hash, E, A> ::iterator unordered_set<T,Hash,E,A>::era
    itNext++;
    
    // Erase
-   (*itErase.itVector).erase(itErase.itList);
+   auto itVector = itErase.itVector;
+   (*itVector).erase(itErase.itList);
    numElements--;
    return itNext;
 }
@@ -418,12 +498,104 @@ custom::pair<typename custom::unordered_set<T, H, E, A>::iterator, bool> unorder
    return custom::pair<custom::unordered_set<T, H, E, A>::iterator, bool>(find(t), true);
 }
 template <typename T, typename H, typename E, typename A>
+custom::pair<typename custom::unordered_set<T, H, E, A>::iterator, bool> unordered_set<T, H, E, A>::insert(T&& t)
+{
+   // Check if element already exists in the unordered set
+   auto itHash = find(t);
+   if (itHash != end())
+      return custom::pair<custom::unordered_set<T, H, E, A>::iterator, bool>(itHash, false);
+
+   return custom::pair<custom::unordered_set<T, H, E, A>::iterator, bool>(insertNew(std::move(t)), true);
+}
+template <typename T, typename H, typename E, typename A>
 void unordered_set<T, H, E, A>::insert(const std::initializer_list<T> & il)
 {
    for (auto item : il)
       insert(item);
 }
 
+/*****************************************
+ * UNORDERED SET :: EXTRACT
+ * Take one element out of the hash without freeing it
+ ****************************************/
+template <typename T, typename H, typename E, typename A>
+typename unordered_set <T, H, E, A> ::node_type unordered_set<T, H, E, A>::extract(const T& t)
+{
+   return extract(find(t));
+}
+template <typename T, typename H, typename E, typename A>
+typename unordered_set <T, H, E, A> ::node_type unordered_set<T, H, E, A>::extract(const iterator& it)
+{
+   node_type nh;
+   if (it == end())
+      return nh;
+
+   // Move the list node out of its bucket and into the handle
+   auto itVector = it.itVector;
+   nh.node.splice(nh.node.end(), *itVector, it.itList);
+   numElements--;
+   return nh;
+}
+
+/*****************************************
+ * UNORDERED SET :: INSERT
+ * Put an extracted element back into a hash. A duplicate
+ * is left in the handle.
+ ****************************************/
+template <typename T, typename H, typename E, typename A>
+custom::pair<typename custom::unordered_set<T, H, E, A>::iterator, bool> unordered_set<T, H, E, A>::insert(node_type&& nh)
+{
+   if (nh.empty())
+      return custom::pair<custom::unordered_set<T, H, E, A>::iterator, bool>(end(), false);
+
+   // Check if element already exists in the unordered set
+   auto itHash = find(nh.value());
+   if (itHash != end())
+      return custom::pair<custom::unordered_set<T, H, E, A>::iterator, bool>(itHash, false);
+
+   // Check if need to reserve more space
+   if (min_buckets_required(numElements + 1) > bucket_count())
+      reserve(numElements * 2);
+
+   // Move the node in. The element itself does not move.
+   size_t index = bucket(nh.value());
+   buckets[index].splice(buckets[index].end(), nh.node);
+   numElements++;
+   return custom::pair<custom::unordered_set<T, H, E, A>::iterator, bool>(find(buckets[index].back()), true);
+}
+
+/*****************************************
+ * UNORDERED SET :: MERGE
+ * Move every element of rhs that we do not already have
+ * into this hash. Duplicates are left behind in rhs.
+ ****************************************/
+template <typename T, typename H, typename E, typename A>
+void unordered_set<T, H, E, A>::merge(unordered_set& rhs)
+{
+   if (this == &rhs)
+      return;
+
+   for (size_t iBucket = 0; iBucket < rhs.bucket_count(); iBucket++)
+   {
+      auto it = rhs.buckets[iBucket].begin();
+      while (it != rhs.buckets[iBucket].end())
+      {
+         auto itNext = it;
+         ++itNext;
+         if (find(*it) == end())
+         {
+            if (min_buckets_required(numElements + 1) > bucket_count())
+               reserve(numElements * 2);
+            size_t index = bucket(*it);
+            buckets[index].splice(buckets[index].end(), rhs.buckets[iBucket], it);
+            numElements++;
+            rhs.numElements--;
+         }
+         it = itNext;
+      }
+   }
+}
+
 /*****************************************
  * UNORDERED SET :: REHASH
  * Re-Hash the unordered set by numBuckets
@@ -452,14 +624,17 @@ void unordered_set<T, Hash, E, A>::rehash(size_t numBuckets)
 
 
 /*****************************************
- * UNORDERED SET :: FIND
- * Find an element in an unordered set
+ * UNORDERED SET :: FIND KEY
+ * Find an element by anything Hash and EqPred accept
+ * alongside T. unordered_map uses this to look up a
+ * key without building a pair around it.
  ****************************************/
 template <typename T, typename H, typename E, typename A>
-typename unordered_set <T, H, E, A> ::iterator unordered_set<T, H, E, A>::find(const T& t)
+template <class Key>
+typename unordered_set <T, H, E, A> ::iterator unordered_set<T, H, E, A>::findKey(const Key& key)
 {
    // Get the index
-   size_t iBucket = bucket(t);
+   size_t iBucket = H()(key) % bucket_count();
    
    // Find the iterator for the bucket
    auto itBucket = typename custom::vector<custom::list<T>>::iterator(iBucket, buckets);
@@ -467,7 +642,7 @@ typename unordered_set <T, H, E, A> ::iterator unordered_set<T, H, E, A>::find(c
    // Check for item
    for (auto it = buckets[iBucket].begin(); it != buckets[iBucket].end(); it++)
    {
-      if (*it == t)
+      if (E()(*it, key))
          return iterator(buckets.end(), itBucket ,it);
    }
    
@@ -475,6 +650,26 @@ typename unordered_set <T, H, E, A> ::iterator unordered_set<T, H, E, A>::find(c
    return end();
 }
 
+/*****************************************
+ * UNORDERED SET :: INSERT NEW
+ * Add an element the caller knows is not already
+ * here, growing first if need be
+ ****************************************/
+template <typename T, typename H, typename E, typename A>
+typename unordered_set <T, H, E, A> ::iterator unordered_set<T, H, E, A>::insertNew(T&& t)
+{
+   // Check if need to reserve more space
+   if (min_buckets_required(numElements + 1) > bucket_count())
+      reserve(numElements * 2);
+
+   // Add element at the back of its bucket
+   size_t index = bucket(t);
+   buckets[index].push_back(std::move(t));
+   numElements++;
+   auto itBucket = typename custom::vector<custom::list<T>>::iterator(index, buckets);
+   return iterator(buckets.end(), itBucket, buckets[index].rbegin());
+}
+
 /*****************************************
  * UNORDERED SET :: ITERATOR :: INCREMENT
  * Advance by one element in an unordered set
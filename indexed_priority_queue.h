@@ -0,0 +1,324 @@
+/***********************************************************************
+ * Header:
+ *    INDEXED PRIORITY QUEUE
+ * Summary:
+ *    A priority queue whose items can be found again after they are
+ *    pushed, so their priority can be changed or they can be removed
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *
+ *    This will contain the class definition of:
+ *        indexed_priority_queue  : A priority queue with handles
+ * Author
+ *    Tyler and Braedon
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <functional> // for std::less
+#include <stdexcept>  // for std::out_of_range
+#include <string>
+#include "vector.h"   // for the heap and the position map
+
+class TestIndexedPQueue;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * INDEXED P QUEUE
+ * A D-ary heap like priority_queue. push() hands back
+ * a handle that stays valid until that item is popped
+ * or erased, after which the handle may be reused.
+ * The heap remembers where every handle lives, so
+ * update() and erase() are O(log n) with no searching.
+ *************************************************/
+template<class T, class Compare = std::less<T>, size_t D = 2>
+class indexed_priority_queue
+{
+   static_assert(D >= 2, "a heap needs at least two children per node");
+
+   friend class ::TestIndexedPQueue; // give the unit test class access to the privates
+
+public:
+   using handle = size_t;
+
+   //
+   // construct
+   //
+   indexed_priority_queue(const Compare & c = Compare()) : compare(c)
+   {
+   }
+
+   //
+   // Access
+   //
+   const T & top() const
+   {
+      if (empty())
+         throw std::out_of_range(std::string("std:out_of_range"));
+      return heap[0].value;
+   }
+   handle top_handle() const
+   {
+      if (empty())
+         throw std::out_of_range(std::string("std:out_of_range"));
+      return heap[0].h;
+   }
+   const T & operator [] (handle h) const
+   {
+      return heap[position(h)].value;
+   }
+   bool contains(handle h) const
+   {
+      return h < positions.size() && positions[h] != npos;
+   }
+
+   //
+   // Insert
+   //
+   handle push(const T & t);
+   handle push(T && t);
+
+   //
+   // Update
+   //
+   void update(handle h, const T & t);
+   void decrease_key(handle h, const T & t);
+
+   //
+   // Remove
+   //
+   void pop()
+   {
+      if (!empty())
+         erase(heap[0].h);
+   }
+   void erase(handle h);
+   void clear()
+   {
+      heap.clear();
+      positions.clear();
+      freeHandles.clear();
+   }
+
+   //
+   // Status
+   //
+   size_t size()  const
+   {
+      return heap.size();
+   }
+   bool empty() const
+   {
+      return heap.size() == 0;
+   }
+
+private:
+
+   // An item in the heap. The value sits next to its handle so the
+   // sift loops compare neighbouring entries without an indirection
+   struct Entry
+   {
+      T value;
+      handle h;
+   };
+
+   static constexpr size_t npos = (size_t)-1;
+
+   size_t position(handle h) const;          // heap array index of a handle
+   handle newHandle();                       // recycle a handle or make one
+   void   place(size_t ia, Entry && entry);  // store an entry and record where
+   bool   percolateUp(size_t ia);            // fix heap from index up. This is an array index!
+   void   percolateDown(size_t ia);          // fix heap from index down. Also an array index
+
+   custom::vector <Entry>  heap;        // the heap itself
+   custom::vector <size_t> positions;   // handle -> heap index, npos when free
+   custom::vector <handle> freeHandles; // handles ready to be reused
+   Compare compare;                     // comparision operator
+};
+
+/************************************************
+ * INDEXED P QUEUE :: PUSH
+ * Add a new item and return the handle to find it again
+ ***********************************************/
+template <class T, class Compare, size_t D>
+typename indexed_priority_queue <T, Compare, D> :: handle
+indexed_priority_queue <T, Compare, D> :: push(const T & t)
+{
+   handle h = newHandle();
+   heap.push_back(Entry{ t, h });
+   positions[h] = heap.size() - 1;
+   percolateUp(heap.size() - 1);
+   return h;
+}
+template <class T, class Compare, size_t D>
+typename indexed_priority_queue <T, Compare, D> :: handle
+indexed_priority_queue <T, Compare, D> :: push(T && t)
+{
+   handle h = newHandle();
+   heap.push_back(Entry{ std::move(t), h });
+   positions[h] = heap.size() - 1;
+   percolateUp(heap.size() - 1);
+   return h;
+}
+
+/************************************************
+ * INDEXED P QUEUE :: UPDATE
+ * Give an item a new priority, higher or lower
+ ***********************************************/
+template <class T, class Compare, size_t D>
+void indexed_priority_queue <T, Compare, D> :: update(handle h, const T & t)
+{
+   size_t ia = position(h);
+   heap[ia].value = t;
+   if (!percolateUp(ia))
+      percolateDown(ia);
+}
+
+/************************************************
+ * INDEXED P QUEUE :: DECREASE KEY
+ * Move an item toward the top. With std::greater
+ * (smallest first, as for shortest paths) this is the
+ * classic decrease-key. Only ever needs to sift up.
+ ***********************************************/
+template <class T, class Compare, size_t D>
+void indexed_priority_queue <T, Compare, D> :: decrease_key(handle h, const T & t)
+{
+   size_t ia = position(h);
+   assert(!compare(t, heap[ia].value));
+   heap[ia].value = t;
+   percolateUp(ia);
+}
+
+/************************************************
+ * INDEXED P QUEUE :: ERASE
+ * Remove an item wherever it is in the heap. The
+ * last item fills the hole and is sifted whichever
+ * way it needs to go.
+ ***********************************************/
+template <class T, class Compare, size_t D>
+void indexed_priority_queue <T, Compare, D> :: erase(handle h)
+{
+   size_t ia = position(h);
+   size_t iaLast = heap.size() - 1;
+   positions[h] = npos;
+   freeHandles.push_back(h);
+
+   if (ia != iaLast)
+   {
+      place(ia, std::move(heap[iaLast]));
+      heap.pop_back();
+      if (!percolateUp(ia))
+         percolateDown(ia);
+   }
+   else
+      heap.pop_back();
+}
+
+/************************************************
+ * INDEXED P QUEUE :: POSITION
+ * Where in the heap a handle's item is
+ ***********************************************/
+template <class T, class Compare, size_t D>
+size_t indexed_priority_queue <T, Compare, D> :: position(handle h) const
+{
+   if (!contains(h))
+      throw std::out_of_range(std::string("invalid indexed_priority_queue handle"));
+   return positions[h];
+}
+
+/************************************************
+ * INDEXED P QUEUE :: NEW HANDLE
+ * Reuse a handle that was given up, if there is one
+ ***********************************************/
+template <class T, class Compare, size_t D>
+typename indexed_priority_queue <T, Compare, D> :: handle
+indexed_priority_queue <T, Compare, D> :: newHandle()
+{
+   if (freeHandles.size() != 0)
+   {
+      handle h = freeHandles.back();
+      freeHandles.pop_back();
+      return h;
+   }
+   positions.push_back(npos);
+   return positions.size() - 1;
+}
+
+/************************************************
+ * INDEXED P QUEUE :: PLACE
+ * Every time an entry moves its handle must learn
+ * where it went. This keeps the two in sync.
+ ***********************************************/
+template <class T, class Compare, size_t D>
+void indexed_priority_queue <T, Compare, D> :: place(size_t ia, Entry && entry)
+{
+   heap[ia] = std::move(entry);
+   positions[heap[ia].h] = ia;
+}
+
+/************************************************
+ * INDEXED P QUEUE :: PERCOLATE UP
+ * Move smaller parents down into the hole until
+ * the item fits. Return TRUE if it moved.
+ ************************************************/
+template <class T, class Compare, size_t D>
+bool indexed_priority_queue <T, Compare, D> :: percolateUp(size_t ia)
+{
+   size_t iaHole = ia;
+   Entry item = std::move(heap[iaHole]);
+   while (iaHole > 0)
+   {
+      size_t iaParent = (iaHole - 1) / D;
+      if (!compare(heap[iaParent].value, item.value))
+         break;
+      place(iaHole, std::move(heap[iaParent]));
+      iaHole = iaParent;
+   }
+   place(iaHole, std::move(item));
+   return iaHole != ia;
+}
+
+/************************************************
+ * INDEXED P QUEUE :: PERCOLATE DOWN
+ * Move the biggest child up into the hole until
+ * the item is at least as big as all its children
+ ************************************************/
+template <class T, class Compare, size_t D>
+void indexed_priority_queue <T, Compare, D> :: percolateDown(size_t ia)
+{
+   size_t num = heap.size();
+   size_t iaHole = ia;
+   if (iaHole * D + 1 >= num)
+      return;
+
+   Entry item = std::move(heap[iaHole]);
+   for (;;)
+   {
+      size_t iaFirst = iaHole * D + 1;   // array index of the first child
+      if (iaFirst >= num)
+         break;
+      size_t iaEnd = (num - iaFirst > D) ? iaFirst + D : num;
+
+      // Find the biggest of the children
+      size_t iaBigger = iaFirst;
+      for (size_t iaChild = iaFirst + 1; iaChild < iaEnd; iaChild++)
+         if (compare(heap[iaBigger].value, heap[iaChild].value))
+            iaBigger = iaChild;
+
+      if (!compare(item.value, heap[iaBigger].value))
+         break;
+      place(iaHole, std::move(heap[iaBigger]));
+      iaHole = iaBigger;
+   }
+   place(iaHole, std::move(item));
+}
+
+};
@@ -0,0 +1,265 @@
+/***********************************************************************
+ * Header:
+ *    INTRUSIVE LIST
+ * Summary:
+ *    A doubly linked list of objects that carry their own links
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *
+ *    This will contain the class definition of:
+ *        list_hook                 : The links an object carries
+ *        intrusive_list            : A list threaded through the hooks
+ *        intrusive_list::iterator  : An iterator through the list
+ * Author
+ *    Tyler and Braedon
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>   // for size_t
+#include <utility>   // for std::swap
+
+class TestIntrusiveList;    // forward declaration for unit tests
+
+namespace custom
+{
+
+/**************************************************
+ * LIST HOOK
+ * Put one of these in a class for every list an
+ * object of that class can be in at the same time
+ **************************************************/
+template <typename T>
+struct list_hook
+{
+   list_hook() : pNext(nullptr), pPrev(nullptr)
+   {
+   }
+   T * pNext;       // next object in the list
+   T * pPrev;       // previous object in the list
+};
+
+/**************************************************
+ * INTRUSIVE LIST
+ * Like list, except the list never owns, copies,
+ * allocates or frees anything: it links the objects
+ * it is given through their Hook member. An object
+ * must outlive its time in the list, and may be in
+ * as many lists at once as it has hooks.
+ **************************************************/
+template <typename T, list_hook<T> T::*Hook>
+class intrusive_list
+{
+   friend class ::TestIntrusiveList; // give unit tests access to the privates
+public:
+
+   //
+   // Construct
+   //
+
+   intrusive_list() : numElements(0), pHead(nullptr), pTail(nullptr)
+   {
+   }
+   intrusive_list(intrusive_list && rhs) : intrusive_list()
+   {
+      swap(rhs);
+   }
+   intrusive_list(const intrusive_list & rhs) = delete;
+   intrusive_list & operator = (const intrusive_list & rhs) = delete;
+   intrusive_list & operator = (intrusive_list && rhs)
+   {
+      clear();
+      swap(rhs);
+      return *this;
+   }
+   void swap(intrusive_list & rhs)
+   {
+      std::swap(numElements, rhs.numElements);
+      std::swap(pHead, rhs.pHead);
+      std::swap(pTail, rhs.pTail);
+   }
+
+   //
+   // Iterator
+   //
+
+   class iterator;
+   iterator begin()  { return iterator(pHead);   }
+   iterator rbegin() { return iterator(pTail);   }
+   iterator end()    { return iterator(nullptr); }
+   iterator iterator_to(T & t) { return iterator(&t); }
+
+   //
+   // Access
+   //
+
+   T & front() { assert(pHead); return *pHead; }
+   T & back()  { assert(pTail); return *pTail; }
+
+   //
+   // Insert
+   //
+
+   void push_front(T & t) { insert(begin(), t); }
+   void push_back (T & t) { insert(end(),   t); }
+   iterator insert(iterator it, T & t);
+
+   //
+   // Remove
+   //
+
+   void pop_front() { if (pHead) erase(begin());  }
+   void pop_back()  { if (pTail) erase(rbegin()); }
+   iterator erase(const iterator & it);
+   void remove(T & t) { erase(iterator_to(t)); }
+   void clear();
+
+   //
+   // Status
+   //
+
+   bool empty()  const { return numElements == 0; }
+   size_t size() const { return numElements;      }
+
+private:
+
+   static list_hook<T> & hook(T * p) { return p->*Hook; }
+
+   size_t numElements; // objects linked in
+   T * pHead;          // pointer to the first object
+   T * pTail;          // pointer to the last object
+};
+
+/*************************************************
+ * INTRUSIVE LIST ITERATOR
+ * Iterate through the objects in the list
+ ************************************************/
+template <typename T, list_hook<T> T::*Hook>
+class intrusive_list <T, Hook> :: iterator
+{
+   friend class ::TestIntrusiveList; // give unit tests access to the privates
+   friend class intrusive_list <T, Hook>;
+public:
+   iterator(T * p = nullptr) : p(p)
+   {
+   }
+
+   // equals, not equals operator
+   bool operator == (const iterator & rhs) const { return p == rhs.p; }
+   bool operator != (const iterator & rhs) const { return p != rhs.p; }
+
+   // dereference operator
+   T & operator *  () { return *p; }
+   T * operator -> () { return  p; }
+
+   // prefix and postfix increment
+   iterator & operator ++ ()
+   {
+      p = hook(p).pNext;
+      return *this;
+   }
+   iterator operator ++ (int postfix)
+   {
+      iterator temp(p);
+      p = hook(p).pNext;
+      return temp;
+   }
+
+   // prefix and postfix decrement
+   iterator & operator -- ()
+   {
+      p = hook(p).pPrev;
+      return *this;
+   }
+   iterator operator -- (int postfix)
+   {
+      iterator temp(p);
+      p = hook(p).pPrev;
+      return temp;
+   }
+
+private:
+   T * p;
+};
+
+/******************************************
+ * INTRUSIVE LIST :: INSERT
+ * Link t in before it
+ *    COST : O(1), no allocation
+ ******************************************/
+template <typename T, list_hook<T> T::*Hook>
+typename intrusive_list <T, Hook> :: iterator
+intrusive_list <T, Hook> :: insert(iterator it, T & t)
+{
+   T * pNew = &t;
+   T * pNext = it.p;
+   T * pPrev = pNext ? hook(pNext).pPrev : pTail;
+
+   hook(pNew).pNext = pNext;
+   hook(pNew).pPrev = pPrev;
+   if (pNext)
+      hook(pNext).pPrev = pNew;
+   else
+      pTail = pNew;
+   if (pPrev)
+      hook(pPrev).pNext = pNew;
+   else
+      pHead = pNew;
+
+   numElements++;
+   return iterator(pNew);
+}
+
+/******************************************
+ * INTRUSIVE LIST :: ERASE
+ * Unlink the object at it, returning the next
+ *    COST : O(1), nothing is freed
+ ******************************************/
+template <typename T, list_hook<T> T::*Hook>
+typename intrusive_list <T, Hook> :: iterator
+intrusive_list <T, Hook> :: erase(const iterator & it)
+{
+   T * p = it.p;
+   assert(p != nullptr);
+   T * pNext = hook(p).pNext;
+   T * pPrev = hook(p).pPrev;
+
+   if (pNext)
+      hook(pNext).pPrev = pPrev;
+   else
+      pTail = pPrev;
+   if (pPrev)
+      hook(pPrev).pNext = pNext;
+   else
+      pHead = pNext;
+
+   hook(p).pNext = hook(p).pPrev = nullptr;
+   numElements--;
+   return iterator(pNext);
+}
+
+/**********************************************
+ * INTRUSIVE LIST :: CLEAR
+ * Unlink every object. The objects themselves
+ * are left alone.
+ **********************************************/
+template <typename T, list_hook<T> T::*Hook>
+void intrusive_list <T, Hook> :: clear()
+{
+   while (pHead != nullptr)
+   {
+      T * p = pHead;
+      pHead = hook(p).pNext;
+      hook(p).pNext = hook(p).pPrev = nullptr;
+   }
+   pTail = nullptr;
+   numElements = 0;
+}
+
+}; // namespace custom
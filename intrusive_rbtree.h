@@ -0,0 +1,593 @@
+/***********************************************************************
+ * Header:
+ *    INTRUSIVE RED-BLACK TREE
+ * Summary:
+ *    A balanced binary search tree of objects that carry their own links
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *
+ *    This will contain the class definition of:
+ *        rbtree_hook                : The links an object carries
+ *        intrusive_rbtree           : A tree threaded through the hooks
+ *        intrusive_rbtree::iterator : An in-order iterator
+ * Author
+ *    Tyler and Braedon
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstddef>    // for size_t
+#include <functional> // for std::less
+#include <utility>    // for std::pair
+
+class TestIntrusiveRBTree;    // forward declaration for unit tests
+
+namespace custom
+{
+
+/**************************************************
+ * RB TREE HOOK
+ * Put one of these in a class for every tree an
+ * object of that class can be in at the same time
+ **************************************************/
+template <typename T>
+struct rbtree_hook
+{
+   rbtree_hook() : pLeft(nullptr), pRight(nullptr), pParent(nullptr), isRed(true)
+   {
+   }
+   T * pLeft;        // left child - smaller
+   T * pRight;       // right child - larger
+   T * pParent;      // parent
+   bool isRed;       // red-black balancing stuff
+};
+
+/**************************************************
+ * INTRUSIVE RB TREE
+ * Like BST, except the tree never owns, copies,
+ * allocates or frees anything: it links the objects
+ * it is given through their Hook member. Compare
+ * orders the objects themselves. An object must
+ * outlive its time in the tree, and must not change
+ * its ordering while it is in there.
+ **************************************************/
+template <typename T, rbtree_hook<T> T::*Hook, typename Compare = std::less<T>>
+class intrusive_rbtree
+{
+   friend class ::TestIntrusiveRBTree; // give unit tests access to the privates
+public:
+
+   //
+   // Construct
+   //
+
+   intrusive_rbtree(const Compare & c = Compare()) : root(nullptr), numElements(0), compare(c)
+   {
+   }
+   intrusive_rbtree(intrusive_rbtree && rhs) : intrusive_rbtree(rhs.compare)
+   {
+      swap(rhs);
+   }
+   intrusive_rbtree(const intrusive_rbtree & rhs) = delete;
+   intrusive_rbtree & operator = (const intrusive_rbtree & rhs) = delete;
+   intrusive_rbtree & operator = (intrusive_rbtree && rhs)
+   {
+      clear();
+      swap(rhs);
+      return *this;
+   }
+   void swap(intrusive_rbtree & rhs)
+   {
+      std::swap(root, rhs.root);
+      std::swap(numElements, rhs.numElements);
+      std::swap(compare, rhs.compare);
+   }
+
+   //
+   // Iterator
+   //
+
+   class iterator;
+   iterator begin() const { return iterator(root ? minimum(root) : nullptr); }
+   iterator end()   const { return iterator(nullptr); }
+   iterator iterator_to(T & t) const { return iterator(&t); }
+
+   //
+   // Access. Key is anything Compare can order against a T
+   //
+
+   template <class Key>
+   iterator find(const Key & k) const;
+   template <class Key>
+   iterator lower_bound(const Key & k) const;
+
+   //
+   // Insert
+   //
+
+   std::pair<iterator, bool> insert(T & t, bool keepUnique = false);
+
+   //
+   // Remove
+   //
+
+   iterator erase(iterator it);
+   void remove(T & t) { erase(iterator_to(t)); }
+   void clear()
+   {
+      root = nullptr;
+      numElements = 0;
+   }
+
+   //
+   // Status
+   //
+
+   bool   empty() const noexcept { return numElements == 0; }
+   size_t size()  const noexcept { return numElements;      }
+
+private:
+
+   static rbtree_hook<T> & hook(T * p) { return p->*Hook; }
+   static bool isRed(T * p)           { return p != nullptr && hook(p).isRed; }
+   static T *  minimum(T * p);
+   static T *  maximum(T * p);
+   static T *  next(T * p);
+   static T *  prev(T * p);
+
+   void rotateLeft (T * p);
+   void rotateRight(T * p);
+   void transplant(T * pOld, T * pNew);
+   void insertFixup(T * p);
+   void eraseFixup(T * p, T * pParent);
+
+   T * root;              // root object of the tree
+   size_t numElements;    // objects linked in
+   Compare compare;       // orders the objects
+};
+
+/**************************************************
+ * INTRUSIVE RB TREE ITERATOR
+ * In-order walk through the tree
+ *************************************************/
+template <typename T, rbtree_hook<T> T::*Hook, typename Compare>
+class intrusive_rbtree <T, Hook, Compare> :: iterator
+{
+   friend class ::TestIntrusiveRBTree; // give unit tests access to the privates
+   friend class intrusive_rbtree <T, Hook, Compare>;
+public:
+   iterator(T * p = nullptr) : p(p)
+   {
+   }
+
+   // equals, not equals operator
+   bool operator == (const iterator & rhs) const { return p == rhs.p; }
+   bool operator != (const iterator & rhs) const { return p != rhs.p; }
+
+   // dereference operator
+   T & operator *  () const { return *p; }
+   T * operator -> () const { return  p; }
+
+   // prefix and postfix increment
+   iterator & operator ++ ()
+   {
+      p = next(p);
+      return *this;
+   }
+   iterator operator ++ (int postfix)
+   {
+      iterator temp(p);
+      p = next(p);
+      return temp;
+   }
+
+   // prefix and postfix decrement
+   iterator & operator -- ()
+   {
+      p = prev(p);
+      return *this;
+   }
+   iterator operator -- (int postfix)
+   {
+      iterator temp(p);
+      p = prev(p);
+      return temp;
+   }
+
+private:
+   T * p;
+};
+
+/****************************************************
+ * INTRUSIVE RB TREE :: FIND
+ * Return the object matching k, or end()
+ ****************************************************/
+template <typename T, rbtree_hook<T> T::*Hook, typename Compare>
+template <class Key>
+typename intrusive_rbtree <T, Hook, Compare> :: iterator
+intrusive_rbtree <T, Hook, Compare> :: find(const Key & k) const
+{
+   iterator it = lower_bound(k);
+   if (it.p != nullptr && !compare(k, *it.p))
+      return it;
+   return end();
+}
+
+/****************************************************
+ * INTRUSIVE RB TREE :: LOWER BOUND
+ * The first object not less than k
+ ****************************************************/
+template <typename T, rbtree_hook<T> T::*Hook, typename Compare>
+template <class Key>
+typename intrusive_rbtree <T, Hook, Compare> :: iterator
+intrusive_rbtree <T, Hook, Compare> :: lower_bound(const Key & k) const
+{
+   T * pResult = nullptr;
+   T * p = root;
+   while (p != nullptr)
+   {
+      if (compare(*p, k))
+         p = hook(p).pRight;
+      else
+      {
+         pResult = p;
+         p = hook(p).pLeft;
+      }
+   }
+   return iterator(pResult);
+}
+
+/****************************************************
+ * INTRUSIVE RB TREE :: INSERT
+ * Link t into the tree. If keepUnique is set and an
+ * equal object is already there, t is left out.
+ *    COST : O(log n), no allocation
+ ****************************************************/
+template <typename T, rbtree_hook<T> T::*Hook, typename Compare>
+std::pair<typename intrusive_rbtree <T, Hook, Compare> :: iterator, bool>
+intrusive_rbtree <T, Hook, Compare> :: insert(T & t, bool keepUnique)
+{
+   T * pParent = nullptr;
+   T * p = root;
+   bool goLeft = false;
+   while (p != nullptr)
+   {
+      pParent = p;
+      if (compare(t, *p))
+      {
+         goLeft = true;
+         p = hook(p).pLeft;
+      }
+      else
+      {
+         if (keepUnique && !compare(*p, t))
+            return std::pair<iterator, bool>(iterator(p), false);
+         goLeft = false;
+         p = hook(p).pRight;
+      }
+   }
+
+   T * pNew = &t;
+   hook(pNew).pLeft = hook(pNew).pRight = nullptr;
+   hook(pNew).pParent = pParent;
+   hook(pNew).isRed = true;
+   if (pParent == nullptr)
+      root = pNew;
+   else if (goLeft)
+      hook(pParent).pLeft = pNew;
+   else
+      hook(pParent).pRight = pNew;
+
+   insertFixup(pNew);
+   numElements++;
+   return std::pair<iterator, bool>(iterator(pNew), true);
+}
+
+/****************************************************
+ * INTRUSIVE RB TREE :: ERASE
+ * Unlink an object, returning the one after it
+ *    COST : O(log n), nothing is freed
+ ****************************************************/
+template <typename T, rbtree_hook<T> T::*Hook, typename Compare>
+typename intrusive_rbtree <T, Hook, Compare> :: iterator
+intrusive_rbtree <T, Hook, Compare> :: erase(iterator it)
+{
+   T * pErase = it.p;
+   assert(pErase != nullptr);
+   T * pNext = next(pErase);
+
+   // pChild moves up into the place of whatever was removed.
+   // If a black node left the path, pChild carries an extra black
+   bool wasRed = hook(pErase).isRed;
+   T * pChild;
+   T * pChildParent;
+
+   if (hook(pErase).pLeft == nullptr)
+   {
+      pChild = hook(pErase).pRight;
+      pChildParent = hook(pErase).pParent;
+      transplant(pErase, pChild);
+   }
+   else if (hook(pErase).pRight == nullptr)
+   {
+      pChild = hook(pErase).pLeft;
+      pChildParent = hook(pErase).pParent;
+      transplant(pErase, pChild);
+   }
+   else
+   {
+      // Two children: the successor takes our place and our colour
+      T * pSuccessor = minimum(hook(pErase).pRight);
+      wasRed = hook(pSuccessor).isRed;
+      pChild = hook(pSuccessor).pRight;
+      if (hook(pSuccessor).pParent == pErase)
+         pChildParent = pSuccessor;
+      else
+      {
+         pChildParent = hook(pSuccessor).pParent;
+         transplant(pSuccessor, pChild);
+         hook(pSuccessor).pRight = hook(pErase).pRight;
+         hook(hook(pSuccessor).pRight).pParent = pSuccessor;
+      }
+      transplant(pErase, pSuccessor);
+      hook(pSuccessor).pLeft = hook(pErase).pLeft;
+      hook(hook(pSuccessor).pLeft).pParent = pSuccessor;
+      hook(pSuccessor).isRed = hook(pErase).isRed;
+   }
+
+   if (!wasRed)
+      eraseFixup(pChild, pChildParent);
+
+   hook(pErase).pLeft = hook(pErase).pRight = hook(pErase).pParent = nullptr;
+   numElements--;
+   return iterator(pNext);
+}
+
+/****************************************************
+ * INTRUSIVE RB TREE :: MINIMUM / MAXIMUM
+ ****************************************************/
+template <typename T, rbtree_hook<T> T::*Hook, typename Compare>
+T * intrusive_rbtree <T, Hook, Compare> :: minimum(T * p)
+{
+   while (hook(p).pLeft != nullptr)
+      p = hook(p).pLeft;
+   return p;
+}
+template <typename T, rbtree_hook<T> T::*Hook, typename Compare>
+T * intrusive_rbtree <T, Hook, Compare> :: maximum(T * p)
+{
+   while (hook(p).pRight != nullptr)
+      p = hook(p).pRight;
+   return p;
+}
+
+/****************************************************
+ * INTRUSIVE RB TREE :: NEXT
+ * In-order successor, or nullptr at the end
+ ****************************************************/
+template <typename T, rbtree_hook<T> T::*Hook, typename Compare>
+T * intrusive_rbtree <T, Hook, Compare> :: next(T * p)
+{
+   if (hook(p).pRight != nullptr)
+      return minimum(hook(p).pRight);
+   T * pParent = hook(p).pParent;
+   while (pParent != nullptr && p == hook(pParent).pRight)
+   {
+      p = pParent;
+      pParent = hook(p).pParent;
+   }
+   return pParent;
+}
+
+/****************************************************
+ * INTRUSIVE RB TREE :: PREV
+ * In-order predecessor, or nullptr at the start
+ ****************************************************/
+template <typename T, rbtree_hook<T> T::*Hook, typename Compare>
+T * intrusive_rbtree <T, Hook, Compare> :: prev(T * p)
+{
+   if (hook(p).pLeft != nullptr)
+      return maximum(hook(p).pLeft);
+   T * pParent = hook(p).pParent;
+   while (pParent != nullptr && p == hook(pParent).pLeft)
+   {
+      p = pParent;
+      pParent = hook(p).pParent;
+   }
+   return pParent;
+}
+
+/****************************************************
+ * INTRUSIVE RB TREE :: ROTATE LEFT
+ * p's right child takes its place
+ ****************************************************/
+template <typename T, rbtree_hook<T> T::*Hook, typename Compare>
+void intrusive_rbtree <T, Hook, Compare> :: rotateLeft(T * p)
+{
+   T * pNew = hook(p).pRight;
+   hook(p).pRight = hook(pNew).pLeft;
+   if (hook(pNew).pLeft != nullptr)
+      hook(hook(pNew).pLeft).pParent = p;
+   transplant(p, pNew);
+   hook(pNew).pLeft = p;
+   hook(p).pParent = pNew;
+}
+
+/****************************************************
+ * INTRUSIVE RB TREE :: ROTATE RIGHT
+ * p's left child takes its place
+ ****************************************************/
+template <typename T, rbtree_hook<T> T::*Hook, typename Compare>
+void intrusive_rbtree <T, Hook, Compare> :: rotateRight(T * p)
+{
+   T * pNew = hook(p).pLeft;
+   hook(p).pLeft = hook(pNew).pRight;
+   if (hook(pNew).pRight != nullptr)
+      hook(hook(pNew).pRight).pParent = p;
+   transplant(p, pNew);
+   hook(pNew).pRight = p;
+   hook(p).pParent = pNew;
+}
+
+/****************************************************
+ * INTRUSIVE RB TREE :: TRANSPLANT
+ * Hang pNew (which may be nullptr) where pOld was
+ ****************************************************/
+template <typename T, rbtree_hook<T> T::*Hook, typename Compare>
+void intrusive_rbtree <T, Hook, Compare> :: transplant(T * pOld, T * pNew)
+{
+   T * pParent = hook(pOld).pParent;
+   if (pParent == nullptr)
+      root = pNew;
+   else if (hook(pParent).pLeft == pOld)
+      hook(pParent).pLeft = pNew;
+   else
+      hook(pParent).pRight = pNew;
+   if (pNew != nullptr)
+      hook(pNew).pParent = pParent;
+}
+
+/****************************************************
+ * INTRUSIVE RB TREE :: INSERT FIXUP
+ * A new red node may sit under a red parent. Either
+ * recolour and push the problem up to the grandparent
+ * (red aunt), or rotate it away (black aunt).
+ ****************************************************/
+template <typename T, rbtree_hook<T> T::*Hook, typename Compare>
+void intrusive_rbtree <T, Hook, Compare> :: insertFixup(T * p)
+{
+   while (p != root && isRed(hook(p).pParent))
+   {
+      T * pParent = hook(p).pParent;
+      T * pGranny = hook(pParent).pParent;
+
+      if (pParent == hook(pGranny).pLeft)
+      {
+         T * pAunt = hook(pGranny).pRight;
+         if (isRed(pAunt))
+         {
+            hook(pParent).isRed = false;
+            hook(pAunt).isRed = false;
+            hook(pGranny).isRed = true;
+            p = pGranny;
+            continue;
+         }
+         if (p == hook(pParent).pRight)
+         {
+            p = pParent;
+            rotateLeft(p);
+            pParent = hook(p).pParent;
+         }
+         hook(pParent).isRed = false;
+         hook(pGranny).isRed = true;
+         rotateRight(pGranny);
+      }
+      else
+      {
+         T * pAunt = hook(pGranny).pLeft;
+         if (isRed(pAunt))
+         {
+            hook(pParent).isRed = false;
+            hook(pAunt).isRed = false;
+            hook(pGranny).isRed = true;
+            p = pGranny;
+            continue;
+         }
+         if (p == hook(pParent).pLeft)
+         {
+            p = pParent;
+            rotateRight(p);
+            pParent = hook(p).pParent;
+         }
+         hook(pParent).isRed = false;
+         hook(pGranny).isRed = true;
+         rotateLeft(pGranny);
+      }
+   }
+   hook(root).isRed = false;
+}
+
+/****************************************************
+ * INTRUSIVE RB TREE :: ERASE FIXUP
+ * The path through p (which may be nullptr, hence
+ * pParent) is one black short. Borrow from the
+ * sibling's side, or recolour the sibling red and
+ * push the shortage up a level.
+ ****************************************************/
+template <typename T, rbtree_hook<T> T::*Hook, typename Compare>
+void intrusive_rbtree <T, Hook, Compare> :: eraseFixup(T * p, T * pParent)
+{
+   while (p != root && !isRed(p))
+   {
+      if (p == hook(pParent).pLeft)
+      {
+         T * pSibling = hook(pParent).pRight;
+         if (isRed(pSibling))
+         {
+            hook(pSibling).isRed = false;
+            hook(pParent).isRed = true;
+            rotateLeft(pParent);
+            pSibling = hook(pParent).pRight;
+         }
+         if (!isRed(hook(pSibling).pLeft) && !isRed(hook(pSibling).pRight))
+         {
+            hook(pSibling).isRed = true;
+            p = pParent;
+            pParent = hook(p).pParent;
+            continue;
+         }
+         if (!isRed(hook(pSibling).pRight))
+         {
+            hook(hook(pSibling).pLeft).isRed = false;
+            hook(pSibling).isRed = true;
+            rotateRight(pSibling);
+            pSibling = hook(pParent).pRight;
+         }
+         hook(pSibling).isRed = hook(pParent).isRed;
+         hook(pParent).isRed = false;
+         hook(hook(pSibling).pRight).isRed = false;
+         rotateLeft(pParent);
+         p = root;
+      }
+      else
+      {
+         T * pSibling = hook(pParent).pLeft;
+         if (isRed(pSibling))
+         {
+            hook(pSibling).isRed = false;
+            hook(pParent).isRed = true;
+            rotateRight(pParent);
+            pSibling = hook(pParent).pLeft;
+         }
+         if (!isRed(hook(pSibling).pLeft) && !isRed(hook(pSibling).pRight))
+         {
+            hook(pSibling).isRed = true;
+            p = pParent;
+            pParent = hook(p).pParent;
+            continue;
+         }
+         if (!isRed(hook(pSibling).pLeft))
+         {
+            hook(hook(pSibling).pRight).isRed = false;
+            hook(pSibling).isRed = true;
+            rotateLeft(pSibling);
+            pSibling = hook(pParent).pLeft;
+         }
+         hook(pSibling).isRed = hook(pParent).isRed;
+         hook(pParent).isRed = false;
+         hook(hook(pSibling).pLeft).isRed = false;
+         rotateRight(pParent);
+         p = root;
+      }
+   }
+   if (p != nullptr)
+      hook(p).isRed = false;
+}
+
+}; // namespace custom
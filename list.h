@@ -22,6 +22,7 @@
 #include <iostream>    // for nullptr
 #include <new>         // std::bad_alloc
 #include <memory>      // for std::allocator
+#include <functional>  // for std::less and std::equal_to
 
 class TestList; // forward declaration for unit tests
 class TestHash; // forward declaration for hash used later
@@ -117,6 +118,29 @@ public:
    void clear();
    iterator erase(const iterator & it);
 
+   //
+   // Splice
+   //
+
+   void splice(iterator pos, list <T, A> & rhs);
+   void splice(iterator pos, list <T, A> & rhs, iterator it);
+   void splice(iterator pos, list <T, A> & rhs, iterator first, iterator last);
+
+   //
+   // Reorder
+   //
+
+   void sort() { sort(std::less<T>()); }
+   template <class Compare>
+   void sort(Compare comp);
+   void merge(list <T, A> & rhs) { merge(rhs, std::less<T>()); }
+   template <class Compare>
+   void merge(list <T, A> & rhs, Compare comp);
+   size_t unique() { return unique(std::equal_to<T>()); }
+   template <class BinaryPredicate>
+   size_t unique(BinaryPredicate same);
+   void reverse();
+
    //
    // Status
    //
@@ -128,6 +152,10 @@ private:
    // nested linked list class
    class Node;
 
+   template <class Compare>
+   static Node * mergeChains(Node * pLeft, Node * pRight, Compare & comp);
+   void relinkPrev();
+
    // member variables
    A    alloc;         // use alloacator for memory allocation
    size_t numElements; // though we could count, it is faster to keep a variable
@@ -766,6 +794,317 @@ typename list <T, A> ::iterator list <T, A> ::insert(list <T, A> ::iterator it,
       return iterator(pNew);
    }}
 
+/******************************************
+ * LIST :: SPLICE
+ * move every node of rhs in front of pos
+ *     INPUT  : the location to move to, the list to take from
+ *     OUTPUT :
+ *     COST   : O(1)
+ ******************************************/
+template <typename T, typename A>
+void list <T, A> :: splice(list <T, A> :: iterator pos, list <T, A> & rhs)
+{
+   if (this == &rhs || rhs.empty())
+      return;
+
+   Node * pFirst = rhs.pHead;
+   Node * pLast = rhs.pTail;
+
+   // Hook the chain up after the node before pos
+   pFirst->pPrev = pos.p ? pos.p->pPrev : pTail;
+   if (pFirst->pPrev)
+      pFirst->pPrev->pNext = pFirst;
+   else
+      pHead = pFirst;
+
+   // Hook the chain up before pos
+   pLast->pNext = pos.p;
+   if (pos.p)
+      pos.p->pPrev = pLast;
+   else
+      pTail = pLast;
+
+   numElements += rhs.numElements;
+   rhs.pHead = rhs.pTail = nullptr;
+   rhs.numElements = 0;
+}
+
+/******************************************
+ * LIST :: SPLICE
+ * move the single node at it from rhs in front of pos.
+ * rhs may be this list.
+ *     INPUT  : the location to move to, the list to take from,
+ *              the node to move
+ *     OUTPUT :
+ *     COST   : O(1)
+ ******************************************/
+template <typename T, typename A>
+void list <T, A> :: splice(list <T, A> :: iterator pos, list <T, A> & rhs,
+                           list <T, A> :: iterator it)
+{
+   Node * p = it.p;
+   if (p == nullptr || p == pos.p)
+      return;
+
+   // Unhook the node from rhs
+   if (p->pPrev)
+      p->pPrev->pNext = p->pNext;
+   else
+      rhs.pHead = p->pNext;
+   if (p->pNext)
+      p->pNext->pPrev = p->pPrev;
+   else
+      rhs.pTail = p->pPrev;
+   rhs.numElements--;
+
+   // Hook it up in front of pos
+   p->pNext = pos.p;
+   p->pPrev = pos.p ? pos.p->pPrev : pTail;
+   if (p->pPrev)
+      p->pPrev->pNext = p;
+   else
+      pHead = p;
+   if (pos.p)
+      pos.p->pPrev = p;
+   else
+      pTail = p;
+   numElements++;
+}
+
+/******************************************
+ * LIST :: SPLICE
+ * move the nodes [first, last) from rhs in front of pos.
+ * rhs may be this list, in which case pos must not be
+ * inside the range.
+ *     INPUT  : the location to move to, the list to take from,
+ *              the range to move
+ *     OUTPUT :
+ *     COST   : O(1) within a list, O(length of the range)
+ *              between lists to keep both sizes right
+ ******************************************/
+template <typename T, typename A>
+void list <T, A> :: splice(list <T, A> :: iterator pos, list <T, A> & rhs,
+                           list <T, A> :: iterator first, list <T, A> :: iterator last)
+{
+   if (first == last || (this == &rhs && pos == last))
+      return;
+
+   Node * pFirst = first.p;
+   Node * pLast = last.p ? last.p->pPrev : rhs.pTail;
+
+   // Count what changes hands
+   if (this != &rhs)
+   {
+      size_t num = 1;
+      for (Node * p = pFirst; p != pLast; p = p->pNext)
+         num++;
+      rhs.numElements -= num;
+      numElements += num;
+   }
+
+   // Unhook the chain from rhs
+   if (pFirst->pPrev)
+      pFirst->pPrev->pNext = last.p;
+   else
+      rhs.pHead = last.p;
+   if (last.p)
+      last.p->pPrev = pFirst->pPrev;
+   else
+      rhs.pTail = pFirst->pPrev;
+
+   // Hook it up in front of pos
+   pFirst->pPrev = pos.p ? pos.p->pPrev : pTail;
+   if (pFirst->pPrev)
+      pFirst->pPrev->pNext = pFirst;
+   else
+      pHead = pFirst;
+   pLast->pNext = pos.p;
+   if (pos.p)
+      pos.p->pPrev = pLast;
+   else
+      pTail = pLast;
+}
+
+/******************************************
+ * LIST :: SORT
+ * Stable bottom-up merge sort that relinks the
+ * nodes where they are. bins[i] holds a sorted run
+ * of 2^i nodes chained through pNext only; each node
+ * taken off the front is carried up through the bins
+ * like a binary counter. The pPrev links are put
+ * back in one pass at the end.
+ *     INPUT  : the ordering to sort by
+ *     OUTPUT :
+ *     COST   : O(n log n), no allocation
+ ******************************************/
+template <typename T, typename A>
+template <class Compare>
+void list <T, A> :: sort(Compare comp)
+{
+   if (numElements < 2)
+      return;
+
+   Node * bins[64] = {};
+   int numBins = 0;
+
+   while (pHead)
+   {
+      // Take the next node off the front
+      Node * pRun = pHead;
+      pHead = pHead->pNext;
+      pRun->pNext = nullptr;
+
+      // Carry it up: bins[i] holds earlier nodes than pRun, so it goes on the left
+      int i = 0;
+      for (; i < numBins && bins[i]; i++)
+      {
+         pRun = mergeChains(bins[i], pRun, comp);
+         bins[i] = nullptr;
+      }
+      if (i == numBins)
+         numBins++;
+      bins[i] = pRun;
+   }
+
+   // Fold the bins together, older (higher) bins on the left
+   Node * pRun = nullptr;
+   for (int i = 0; i < numBins; i++)
+      if (bins[i])
+         pRun = pRun ? mergeChains(bins[i], pRun, comp) : bins[i];
+
+   pHead = pRun;
+   relinkPrev();
+}
+
+/******************************************
+ * LIST :: MERGE
+ * Move every node of sorted rhs into this sorted
+ * list, keeping it sorted. Equal elements from this
+ * list come first.
+ *     INPUT  : a sorted list, the ordering both are sorted by
+ *     OUTPUT :
+ *     COST   : O(n + m), no allocation
+ ******************************************/
+template <typename T, typename A>
+template <class Compare>
+void list <T, A> :: merge(list <T, A> & rhs, Compare comp)
+{
+   if (this == &rhs || rhs.empty())
+      return;
+
+   if (pTail)
+      pTail->pNext = nullptr;
+   if (rhs.pTail)
+      rhs.pTail->pNext = nullptr;
+   pHead = mergeChains(pHead, rhs.pHead, comp);
+   numElements += rhs.numElements;
+   rhs.pHead = rhs.pTail = nullptr;
+   rhs.numElements = 0;
+   relinkPrev();
+}
+
+/******************************************
+ * LIST :: UNIQUE
+ * Remove every element that is the same as the
+ * one right before it
+ *     INPUT  : what counts as the same
+ *     OUTPUT : the number of elements removed
+ *     COST   : O(n)
+ ******************************************/
+template <typename T, typename A>
+template <class BinaryPredicate>
+size_t list <T, A> :: unique(BinaryPredicate same)
+{
+   size_t numRemoved = 0;
+   if (pHead == nullptr)
+      return numRemoved;
+
+   Node * pKeep = pHead;
+   while (pKeep->pNext)
+   {
+      Node * p = pKeep->pNext;
+      if (same(pKeep->data, p->data))
+      {
+         pKeep->pNext = p->pNext;
+         if (p->pNext)
+            p->pNext->pPrev = pKeep;
+         else
+            pTail = pKeep;
+         delete p;
+         numRemoved++;
+      }
+      else
+         pKeep = p;
+   }
+   numElements -= numRemoved;
+   return numRemoved;
+}
+
+/******************************************
+ * LIST :: REVERSE
+ * Reverse the order of the nodes by swapping
+ * each node's links
+ *     COST   : O(n), no allocation
+ ******************************************/
+template <typename T, typename A>
+void list <T, A> :: reverse()
+{
+   for (Node * p = pHead; p; p = p->pPrev)
+      std::swap(p->pNext, p->pPrev);
+   std::swap(pHead, pTail);
+}
+
+/******************************************
+ * LIST :: MERGE CHAINS
+ * Merge two sorted nullptr-terminated chains
+ * through pNext only. Ties go to the left chain.
+ *     INPUT  : two sorted chains, the ordering
+ *     OUTPUT : the head of the merged chain
+ *     COST   : O(n + m)
+ ******************************************/
+template <typename T, typename A>
+template <class Compare>
+typename list <T, A> :: Node * list <T, A> :: mergeChains(Node * pLeft, Node * pRight,
+                                                          Compare & comp)
+{
+   Node * pHead = nullptr;
+   Node ** ppTail = &pHead;
+   while (pLeft && pRight)
+   {
+      if (comp(pRight->data, pLeft->data))
+      {
+         *ppTail = pRight;
+         pRight = pRight->pNext;
+      }
+      else
+      {
+         *ppTail = pLeft;
+         pLeft = pLeft->pNext;
+      }
+      ppTail = &(*ppTail)->pNext;
+   }
+   *ppTail = pLeft ? pLeft : pRight;
+   return pHead;
+}
+
+/******************************************
+ * LIST :: RELINK PREV
+ * Rebuild every pPrev and pTail from the pNext
+ * chain that starts at pHead
+ *     COST   : O(n)
+ ******************************************/
+template <typename T, typename A>
+void list <T, A> :: relinkPrev()
+{
+   Node * pPrev = nullptr;
+   for (Node * p = pHead; p; p = p->pNext)
+   {
+      p->pPrev = pPrev;
+      pPrev = p;
+   }
+   pTail = pPrev;
+}
+
 /**********************************************
  * LIST :: SWAP
  * Swap one list with another
@@ -0,0 +1,433 @@
+/***********************************************************************
+ * Header:
+ *    LOUDS TRIE
+ * Summary:
+ *    A read-only set of strings, kept as a trie in a few bits per
+ *    node, that answers prefix queries
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        louds_bits   : A bit vector with fast select
+ *        louds_trie   : A succinct trie over a fixed set of strings
+ * Author
+ *    Tyler and Braeden
+ ************************************************************************/
+
+#pragma once
+
+#include "vector.h"    // the bits and the labels live in vectors
+#include <algorithm>   // for std::sort, std::is_sorted and std::lower_bound
+#include <cstdint>     // for uint8_t, uint32_t and uint64_t
+#include <string>      // for std::string
+
+class TestLoudsTrie;    // forward declaration for unit tests
+
+namespace custom
+{
+
+/************************************************
+ * LOUDS BITS
+ * Bits appended one at a time, then frozen. After
+ * that, select0(i) finds the i-th 0 by jumping to
+ * a sampled 512-bit block, skipping whole blocks by
+ * their counts, then whole words by popcount.
+ ************************************************/
+class louds_bits
+{
+   friend class ::TestLoudsTrie;   // give unit tests access to the privates
+public:
+   louds_bits() : numBits(0)
+   {
+   }
+
+   void push_back(bool bit)
+   {
+      if (numBits % 64 == 0)
+         words.push_back(0);
+      if (bit)
+         words[numBits / 64] |= (uint64_t)1 << (numBits % 64);
+      numBits++;
+   }
+   bool operator [] (size_t pos) const
+   {
+      return (words[pos / 64] >> (pos % 64)) & 1;
+   }
+   size_t size() const
+   {
+      return numBits;
+   }
+
+   void freeze();
+   size_t select0(size_t i) const;
+   size_t nextZero(size_t pos) const;
+   size_t rank1(size_t pos) const;
+
+private:
+   static const size_t wordsPerBlock = 8;    // 512 bits, one cache line
+   static const size_t zerosPerSample = 512;
+
+   static unsigned popcount(uint64_t x)
+   {
+#if defined(__GNUC__) || defined(__clang__)
+      return (unsigned)__builtin_popcountll(x);
+#else
+      unsigned bits = 0;
+      for (; x; x &= x - 1)
+         bits++;
+      return bits;
+#endif
+   }
+   // The position of the i-th 1 in x, which has more than i
+   static unsigned selectInWord(uint64_t x, size_t i)
+   {
+      for (; i > 0; i--)
+         x &= x - 1;
+#if defined(__GNUC__) || defined(__clang__)
+      return (unsigned)__builtin_ctzll(x);
+#else
+      unsigned pos = 0;
+      for (; (x & 1) == 0; x >>= 1)
+         pos++;
+      return pos;
+#endif
+   }
+   // Bits past the end read as 1, so they are never taken for a 0
+   uint64_t zerosIn(size_t iWord) const
+   {
+      uint64_t w = ~words[iWord];
+      size_t numValid = numBits - iWord * 64;
+      if (numValid < 64)
+         w &= ((uint64_t)1 << numValid) - 1;
+      return w;
+   }
+
+   custom::vector<uint64_t> words;       // the bits, low bit first
+   custom::vector<uint32_t> blockOnes;   // ones before each block
+   custom::vector<uint32_t> samples;     // the block of every 512th zero
+   size_t numBits;
+};
+
+/************************************************
+ * LOUDS TRIE
+ * A trie of every prefix of the keys, written out
+ * level by level (LOUDS: level-order unary degree
+ * sequence). Each node in turn puts down a 1 for
+ * each child and then a 0, and its children's
+ * labels, in order. Node 0 is the root. The node a
+ * 1 leads to is one more than the number of 1s
+ * before it, so the tree is walked with select0
+ * and simple arithmetic. No pointers are stored:
+ * a node costs about two bits, a byte of label,
+ * and one bit saying whether a key ends there.
+ ************************************************/
+class louds_trie
+{
+   friend class ::TestLoudsTrie;   // give unit tests access to the privates
+public:
+
+   //
+   // Construct
+   //
+   louds_trie() : numKeys(0)
+   {
+      custom::vector<std::string> keys;
+      build(keys);
+   }
+   template <class Iterator>
+   louds_trie(Iterator first, Iterator last) : numKeys(0)
+   {
+      custom::vector<std::string> keys;
+      for (; first != last; ++first)
+         keys.push_back(*first);
+      build(keys);
+   }
+   louds_trie(const std::initializer_list <std::string>& il) : louds_trie(il.begin(), il.end())
+   {
+   }
+
+   //
+   // Access
+   //
+   bool contains(const std::string& key) const
+   {
+      size_t node = descend(key);
+      return node != npos && terminal[node];
+   }
+   size_t count(const std::string& key) const
+   {
+      return contains(key) ? 1 : 0;
+   }
+   template <class Function>
+   void for_each_prefix(const std::string& prefix, Function f) const;
+   custom::vector<std::string> prefix_range(const std::string& prefix,
+                                            size_t maxResults = npos) const;
+
+   //
+   // Status
+   //
+   size_t size() const       { return numKeys;        }
+   bool empty() const        { return numKeys == 0;   }
+   size_t node_count() const { return terminal.size(); }
+
+private:
+   static const size_t npos = (size_t)-1;
+
+   void build(custom::vector<std::string>& keys);
+   size_t child(size_t node, uint8_t label) const;
+   size_t descend(const std::string& key) const;
+   template <class Function>
+   bool walk(size_t node, std::string& key, Function& f) const;
+
+   // The first bit of a node's run of 1s, and the 0 that ends it
+   size_t runStart(size_t node) const
+   {
+      return node == 0 ? 0 : bits.select0(node - 1) + 1;
+   }
+
+   louds_bits bits;                  // a run of 1s and a 0 for each node
+   custom::vector<uint8_t> labels;   // labels[e] is the byte on the edge into node e + 1
+   louds_bits terminal;              // whether a key ends at each node
+   size_t numKeys;                   // number of keys
+};
+
+/*****************************************
+ * LOUDS BITS :: FREEZE
+ * Count the 1s before every block, and note
+ * which block every 512th 0 is in
+ ****************************************/
+inline void louds_bits::freeze()
+{
+   blockOnes.clear();
+   samples.clear();
+   size_t ones = 0;
+   size_t zeros = 0;
+   for (size_t iWord = 0; iWord < words.size(); iWord++)
+   {
+      if (iWord % wordsPerBlock == 0)
+         blockOnes.push_back((uint32_t)ones);
+      size_t z = popcount(zerosIn(iWord));
+      // Each sample crossed in this word belongs to this block
+      while (samples.size() * zerosPerSample < zeros + z)
+         samples.push_back((uint32_t)(iWord / wordsPerBlock));
+      zeros += z;
+      ones += popcount(words[iWord]);
+   }
+   blockOnes.push_back((uint32_t)ones);
+}
+
+/*****************************************
+ * LOUDS BITS :: RANK 1
+ * The number of 1s before pos
+ ****************************************/
+inline size_t louds_bits::rank1(size_t pos) const
+{
+   size_t iWord = pos / 64;
+   size_t ones = blockOnes[iWord / wordsPerBlock];
+   for (size_t w = iWord / wordsPerBlock * wordsPerBlock; w < iWord; w++)
+      ones += popcount(words[w]);
+   if (pos % 64)
+      ones += popcount(words[iWord] & (((uint64_t)1 << (pos % 64)) - 1));
+   return ones;
+}
+
+/*****************************************
+ * LOUDS BITS :: SELECT 0
+ * The position of the i-th 0, counting from 0
+ ****************************************/
+inline size_t louds_bits::select0(size_t i) const
+{
+   // Start at the block holding the nearest sampled zero before,
+   // then skip blocks while the 0 is past them
+   size_t iBlock = samples[i / zerosPerSample];
+   size_t numBlocks = blockOnes.size() - 1;
+   while (iBlock + 1 < numBlocks &&
+          (iBlock + 1) * wordsPerBlock * 64 - blockOnes[iBlock + 1] <= i)
+      iBlock++;
+
+   // Then words
+   size_t zeros = iBlock * wordsPerBlock * 64 - blockOnes[iBlock];
+   size_t iWord = iBlock * wordsPerBlock;
+   for (;; iWord++)
+   {
+      size_t z = popcount(zerosIn(iWord));
+      if (zeros + z > i)
+         break;
+      zeros += z;
+   }
+   return iWord * 64 + selectInWord(zerosIn(iWord), i - zeros);
+}
+
+/*****************************************
+ * LOUDS BITS :: NEXT ZERO
+ * The first 0 at or after pos. In a LOUDS this
+ * is the end of a node's run, usually in the
+ * same word.
+ ****************************************/
+inline size_t louds_bits::nextZero(size_t pos) const
+{
+   size_t iWord = pos / 64;
+   uint64_t w = zerosIn(iWord) & (~(uint64_t)0 << (pos % 64));
+   while (w == 0)
+      w = zerosIn(++iWord);
+   return iWord * 64 + selectInWord(w, 0);
+}
+
+/*****************************************
+ * LOUDS TRIE :: BUILD
+ * Sort the keys if they are not, drop repeats, then
+ * go level by level. Each node is the run of sorted
+ * keys sharing its prefix; its children are that run
+ * split by the next byte.
+ ****************************************/
+inline void louds_trie::build(custom::vector<std::string>& keys)
+{
+   if (!keys.empty())
+   {
+      std::string* p = &keys[0];
+      size_t n = keys.size();
+      if (!std::is_sorted(p, p + n))
+         std::sort(p, p + n);
+      numKeys = std::unique(p, p + n) - p;
+   }
+
+   // A node: keys[first, last), all sharing their first depth bytes
+   struct Run
+   {
+      size_t first;
+      size_t last;
+      size_t depth;
+   };
+   custom::vector<Run> level;
+   custom::vector<Run> next;
+   level.push_back(Run{ 0, numKeys, 0 });
+   while (!level.empty())
+   {
+      for (size_t r = 0; r < level.size(); r++)
+      {
+         Run run = level[r];
+         size_t i = run.first;
+
+         // Sorted, so a key that ends here comes first
+         bool ends = i < run.last && keys[i].size() == run.depth;
+         terminal.push_back(ends);
+         if (ends)
+            i++;
+
+         while (i < run.last)
+         {
+            uint8_t label = (uint8_t)keys[i][run.depth];
+            size_t j = i + 1;
+            while (j < run.last && (uint8_t)keys[j][run.depth] == label)
+               j++;
+            bits.push_back(true);
+            labels.push_back(label);
+            next.push_back(Run{ i, j, run.depth + 1 });
+            i = j;
+         }
+         bits.push_back(false);
+      }
+      level.swap(next);
+      next.clear();
+   }
+
+   bits.freeze();
+   terminal.freeze();
+}
+
+/*****************************************
+ * LOUDS TRIE :: CHILD
+ * The child of node along label, or npos. The
+ * node's labels are in order, so binary search.
+ ****************************************/
+inline size_t louds_trie::child(size_t node, uint8_t label) const
+{
+   size_t start = runStart(node);
+   size_t end = bits.nextZero(start);
+   if (start == end)
+      return npos;
+   size_t firstEdge = start - node;   // every earlier node left one 0
+   const uint8_t* p = &labels[0];
+   const uint8_t* pFound = std::lower_bound(p + firstEdge, p + firstEdge + (end - start), label);
+   if (pFound == p + firstEdge + (end - start) || *pFound != label)
+      return npos;
+   return (size_t)(pFound - p) + 1;
+}
+
+/*****************************************
+ * LOUDS TRIE :: DESCEND
+ * The node for key, or npos if no key starts with it
+ ****************************************/
+inline size_t louds_trie::descend(const std::string& key) const
+{
+   size_t node = 0;
+   for (size_t i = 0; i < key.size() && node != npos; i++)
+      node = child(node, (uint8_t)key[i]);
+   return node;
+}
+
+/*****************************************
+ * LOUDS TRIE :: WALK
+ * Depth first from node, so the keys come out in
+ * order. A node's children are numbered one after
+ * another. Stops, returning false, when f does.
+ ****************************************/
+template <class Function>
+bool louds_trie::walk(size_t node, std::string& key, Function& f) const
+{
+   if (terminal[node] && !f(key))
+      return false;
+
+   size_t start = runStart(node);
+   size_t end = bits.nextZero(start);
+   for (size_t pos = start; pos < end; pos++)
+   {
+      size_t edge = pos - node;
+      key.push_back((char)labels[edge]);
+      bool more = walk(edge + 1, key, f);
+      key.pop_back();
+      if (!more)
+         return false;
+   }
+   return true;
+}
+
+/*****************************************
+ * LOUDS TRIE :: FOR EACH PREFIX
+ * Call f on every key starting with prefix, in
+ * order, until f returns false
+ ****************************************/
+template <class Function>
+void louds_trie::for_each_prefix(const std::string& prefix, Function f) const
+{
+   size_t node = descend(prefix);
+   if (node == npos)
+      return;
+   std::string key(prefix);
+   walk(node, key, f);
+}
+
+/*****************************************
+ * LOUDS TRIE :: PREFIX RANGE
+ * The keys starting with prefix, in order, at
+ * most maxResults of them
+ ****************************************/
+inline custom::vector<std::string> louds_trie::prefix_range(const std::string& prefix,
+                                                           size_t maxResults) const
+{
+   custom::vector<std::string> results;
+   if (maxResults == 0)
+      return results;
+   for_each_prefix(prefix, [&](const std::string& key)
+   {
+      results.push_back(key);
+      return results.size() < maxResults;
+   });
+   return results;
+}
+
+}
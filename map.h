@@ -127,12 +127,12 @@ public:
    //
    custom::pair<typename map::iterator, bool> insert(Pairs && rhs)
    {
-      auto pair = bst.insert(std::move(rhs));
+      auto pair = bst.insert(std::move(rhs), true);
       return make_pair(iterator(pair.first), pair.second);
    }
    custom::pair<typename map::iterator, bool> insert(const Pairs & rhs)
    {
-      auto pair = bst.insert(rhs);
+      auto pair = bst.insert(rhs, true);
       return make_pair(iterator(pair.first), pair.second);
    }
 
@@ -164,6 +164,28 @@ public:
    iterator erase(iterator it);
    iterator erase(iterator first, iterator last);
 
+   //
+   // Node Handles
+   //
+   using node_type = typename BST <Pairs> :: node_type;
+   node_type extract(iterator it)
+   {
+      return bst.extract(it.it);
+   }
+   node_type extract(const K & k)
+   {
+      return bst.extract(bst.find(k));
+   }
+   custom::pair<typename map::iterator, bool> insert(node_type && nh)
+   {
+      auto pair = bst.insert(std::move(nh), true);
+      return make_pair(iterator(pair.first), pair.second);
+   }
+   void merge(map & rhs)
+   {
+      bst.merge(rhs.bst, true);
+   }
+
    //
    // Status
    //
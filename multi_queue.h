@@ -0,0 +1,288 @@
+/***********************************************************************
+ * Header:
+ *    MULTI QUEUE
+ * Summary:
+ *    A concurrent priority queue for many threads: it trades strict
+ *    ordering for throughput by spreading the items over many heaps
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *
+ *    This will contain the class definition of:
+ *        multi_queue          : A relaxed concurrent priority queue
+ * Author
+ *    Tyler and Braedon
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <atomic>           // for std::atomic
+#include <cstdint>          // for uint64_t
+#include <functional>       // for std::less and std::hash
+#include <memory>           // for std::allocator
+#include <new>              // for placement new
+#include <mutex>            // for std::mutex
+#include <thread>           // for std::thread::hardware_concurrency
+#include "priority_queue.h" // each lane is one of our heaps
+
+class TestMultiQueue;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * MULTI QUEUE
+ * c * P lanes, each a priority_queue behind its own
+ * mutex. push() drops the item in any lane it can lock.
+ * try_pop() looks at two lanes picked at random and
+ * pops from the one with the better top. With many
+ * more lanes than threads, threads rarely meet on a
+ * lock, and the item popped is almost always one of
+ * the best few in the whole queue.
+ *************************************************/
+template <class T, class Compare = std::less<T>, size_t D = 2>
+class multi_queue
+{
+   friend class ::TestMultiQueue; // give the unit test class access to the privates
+
+public:
+
+   //
+   // construct
+   //
+   multi_queue(size_t lanesPerThread = 2, const Compare & c = Compare());
+   multi_queue(const multi_queue & rhs) = delete;
+   multi_queue & operator = (const multi_queue & rhs) = delete;
+   ~multi_queue();
+
+   //
+   // Insert
+   //
+   void push(const T & t);
+   void push(T && t);
+
+   //
+   // Remove
+   //
+   bool try_pop(T & t);
+
+   //
+   // Status. Only a snapshot while other threads are busy
+   //
+   size_t size() const
+   {
+      return numElements.load(std::memory_order_relaxed);
+   }
+   bool empty() const
+   {
+      return size() == 0;
+   }
+
+private:
+
+   // One heap and its lock. Each lane gets its own cache lines so
+   // threads working on neighbouring lanes do not slow each other down
+   struct alignas(64) Lane
+   {
+      Lane(const Compare & c) : heap(c), count(0)
+      {
+      }
+      std::mutex mutex;
+      custom::priority_queue <T, custom::vector<T>, Compare, D> heap;
+      std::atomic <size_t> count;   // heap.size() that can be read without the lock
+   };
+
+   size_t randomLane() const;
+   template <class U>
+   void pushLane(U && u);
+   bool popLane(Lane & lane, T & t);
+
+   Lane * lanes;                       // the heaps
+   size_t numLanes;                    // how many heaps
+   std::atomic <size_t> numElements;   // items in all the heaps together
+   Compare compare;                    // comparision operator
+};
+
+/************************************************
+ * MULTI QUEUE :: CONSTRUCTOR
+ * A few lanes for every thread the machine can run
+ ***********************************************/
+template <class T, class Compare, size_t D>
+multi_queue <T, Compare, D> :: multi_queue(size_t lanesPerThread, const Compare & c) :
+   numElements(0), compare(c)
+{
+   size_t numThreads = std::thread::hardware_concurrency();
+   if (numThreads == 0)
+      numThreads = 1;
+   numLanes = (lanesPerThread == 0 ? 1 : lanesPerThread) * numThreads;
+   if (numLanes < 2)
+      numLanes = 2;
+
+   // Lanes have no default: every heap must order by our compare
+   std::allocator <Lane> alloc;
+   lanes = alloc.allocate(numLanes);
+   size_t numBuilt = 0;
+   try
+   {
+      for (; numBuilt < numLanes; numBuilt++)
+         new (lanes + numBuilt) Lane(compare);
+   }
+   catch (...)
+   {
+      while (numBuilt > 0)
+         lanes[--numBuilt].~Lane();
+      alloc.deallocate(lanes, numLanes);
+      throw;
+   }
+}
+
+/************************************************
+ * MULTI QUEUE :: DESTRUCTOR
+ ***********************************************/
+template <class T, class Compare, size_t D>
+multi_queue <T, Compare, D> :: ~multi_queue()
+{
+   for (size_t i = 0; i < numLanes; i++)
+      lanes[i].~Lane();
+   std::allocator <Lane> ().deallocate(lanes, numLanes);
+}
+
+/************************************************
+ * MULTI QUEUE :: PUSH
+ * Put the item in whichever random lane is free
+ ***********************************************/
+template <class T, class Compare, size_t D>
+void multi_queue <T, Compare, D> :: push(const T & t)
+{
+   pushLane(t);
+}
+template <class T, class Compare, size_t D>
+void multi_queue <T, Compare, D> :: push(T && t)
+{
+   pushLane(std::move(t));
+}
+
+/************************************************
+ * MULTI QUEUE :: TRY POP
+ * Take a near-best item. Returns FALSE only when
+ * every lane was found empty.
+ ***********************************************/
+template <class T, class Compare, size_t D>
+bool multi_queue <T, Compare, D> :: try_pop(T & t)
+{
+   // The usual case: the better of two random lanes
+   for (size_t attempt = 0; attempt < numLanes; attempt++)
+   {
+      if (numElements.load(std::memory_order_relaxed) == 0)
+         break;
+
+      size_t i = randomLane();
+      size_t j = randomLane();
+      if (lanes[j].count.load(std::memory_order_relaxed) == 0)
+         j = i;
+      if (lanes[i].count.load(std::memory_order_relaxed) == 0)
+         i = j;
+      if (lanes[i].count.load(std::memory_order_relaxed) == 0)
+         continue;
+
+      if (i == j)
+      {
+         std::unique_lock <std::mutex> lock(lanes[i].mutex, std::try_to_lock);
+         if (lock.owns_lock() && popLane(lanes[i], t))
+            return true;
+         continue;
+      }
+
+      // Lock both without waiting; if either is busy, try two others
+      std::unique_lock <std::mutex> lockI(lanes[i].mutex, std::try_to_lock);
+      if (!lockI.owns_lock())
+         continue;
+      std::unique_lock <std::mutex> lockJ(lanes[j].mutex, std::try_to_lock);
+      if (!lockJ.owns_lock())
+         continue;
+
+      if (lanes[i].heap.empty() && lanes[j].heap.empty())
+         continue;
+      Lane & better = lanes[i].heap.empty() ? lanes[j] :
+                      lanes[j].heap.empty() ? lanes[i] :
+                      compare(lanes[i].heap.top(), lanes[j].heap.top()) ? lanes[j] : lanes[i];
+      if (popLane(better, t))
+         return true;
+   }
+
+   // Nearly empty or very busy: visit every lane, waiting for each lock
+   for (size_t i = 0; i < numLanes; i++)
+   {
+      std::lock_guard <std::mutex> lock(lanes[i].mutex);
+      if (popLane(lanes[i], t))
+         return true;
+   }
+   return false;
+}
+
+/************************************************
+ * MULTI QUEUE :: RANDOM LANE
+ * Each thread has its own xorshift generator so
+ * choosing a lane needs no shared state
+ ***********************************************/
+template <class T, class Compare, size_t D>
+size_t multi_queue <T, Compare, D> :: randomLane() const
+{
+   static thread_local uint64_t state =
+      std::hash<std::thread::id>()(std::this_thread::get_id()) | 1;
+   state ^= state << 13;
+   state ^= state >> 7;
+   state ^= state << 17;
+   return (size_t)(state % numLanes);
+}
+
+/************************************************
+ * MULTI QUEUE :: PUSH LANE
+ * Try random lanes until one is free. After a few
+ * misses, just wait on the last one.
+ ***********************************************/
+template <class T, class Compare, size_t D>
+template <class U>
+void multi_queue <T, Compare, D> :: pushLane(U && u)
+{
+   size_t i = randomLane();
+   for (int attempt = 0; attempt < 8; attempt++, i = randomLane())
+   {
+      std::unique_lock <std::mutex> lock(lanes[i].mutex, std::try_to_lock);
+      if (lock.owns_lock())
+      {
+         lanes[i].heap.push(std::forward<U>(u));
+         lanes[i].count.store(lanes[i].heap.size(), std::memory_order_relaxed);
+         numElements.fetch_add(1, std::memory_order_relaxed);
+         return;
+      }
+   }
+
+   std::lock_guard <std::mutex> lock(lanes[i].mutex);
+   lanes[i].heap.push(std::forward<U>(u));
+   lanes[i].count.store(lanes[i].heap.size(), std::memory_order_relaxed);
+   numElements.fetch_add(1, std::memory_order_relaxed);
+}
+
+/************************************************
+ * MULTI QUEUE :: POP LANE
+ * Take the top of a lane we hold the lock for
+ ***********************************************/
+template <class T, class Compare, size_t D>
+bool multi_queue <T, Compare, D> :: popLane(Lane & lane, T & t)
+{
+   if (lane.heap.empty())
+      return false;
+   t = lane.heap.top();
+   lane.heap.pop();
+   lane.count.store(lane.heap.size(), std::memory_order_relaxed);
+   numElements.fetch_sub(1, std::memory_order_relaxed);
+   return true;
+}
+
+};
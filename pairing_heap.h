@@ -0,0 +1,485 @@
+/***********************************************************************
+ * Header:
+ *    PAIRING HEAP
+ * Summary:
+ *    A pointer-based heap where two heaps merge in constant time
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *
+ *    This will contain the class definition of:
+ *        pairing_heap           : A heap-ordered multiway tree
+ *        pairing_heap::handle   : A way back to one item in the heap
+ * Author
+ *    Tyler and Braedon
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <functional> // for std::less
+#include <memory>     // for std::allocator
+#include <stdexcept>  // for std::out_of_range
+#include <string>
+#include "vector.h"   // for walking a heap to copy it
+
+class TestPairingHeap;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * PAIRING HEAP
+ * Each node keeps its first child and its next sibling,
+ * and a back pointer to whichever of those points at it.
+ * Two heaps are combined by making the smaller root the
+ * first child of the bigger one: push and meld are O(1).
+ * pop pairs up the root's children left to right, then
+ * combines the pairs right to left: O(log n) amortized.
+ *************************************************/
+template <class T, class Compare = std::less<T>, class A = std::allocator<T>>
+class pairing_heap
+{
+   friend class ::TestPairingHeap; // give the unit test class access to the privates
+
+   class Node;
+   using NodeAlloc  = typename std::allocator_traits<A>::template rebind_alloc<Node>;
+   using NodeTraits = std::allocator_traits<NodeAlloc>;
+
+public:
+   class handle;
+
+   //
+   // construct
+   //
+   pairing_heap(const Compare & c = Compare(), const A & a = A()) :
+      pRoot(nullptr), numElements(0), compare(c), alloc(a)
+   {
+   }
+   pairing_heap(const pairing_heap & rhs);
+   pairing_heap(pairing_heap && rhs) :
+      pRoot(rhs.pRoot), numElements(rhs.numElements),
+      compare(std::move(rhs.compare)), alloc(std::move(rhs.alloc))
+   {
+      rhs.pRoot = nullptr;
+      rhs.numElements = 0;
+   }
+   ~pairing_heap()
+   {
+      clear();
+   }
+
+   //
+   // Assign
+   //
+   pairing_heap & operator = (const pairing_heap & rhs)
+   {
+      pairing_heap copy(rhs);
+      swap(copy);
+      return *this;
+   }
+   pairing_heap & operator = (pairing_heap && rhs)
+   {
+      clear();
+      swap(rhs);
+      return *this;
+   }
+   void swap(pairing_heap & rhs)
+   {
+      using std::swap;
+      swap(pRoot, rhs.pRoot);
+      swap(numElements, rhs.numElements);
+      swap(compare, rhs.compare);
+      swap(alloc, rhs.alloc);
+   }
+
+   //
+   // Access
+   //
+   const T & top() const
+   {
+      if (empty())
+         throw std::out_of_range(std::string("std:out_of_range"));
+      return pRoot->data;
+   }
+
+   //
+   // Insert
+   //
+   handle push(const T & t);
+   handle push(T && t);
+   void   meld(pairing_heap & rhs);
+
+   //
+   // Update
+   //
+   void decrease_key(const handle & h, const T & t);
+
+   //
+   // Remove
+   //
+   void pop();
+   void erase(const handle & h);
+   void clear();
+
+   //
+   // Status
+   //
+   size_t size() const
+   {
+      return numElements;
+   }
+   bool empty() const
+   {
+      return numElements == 0;
+   }
+
+private:
+
+   template <class U>
+   Node * newNode(U && u);
+   void   deleteNode(Node * p);
+   Node * link(Node * p1, Node * p2) const;
+   Node * combineSiblings(Node * pFirst) const;
+   static void detach(Node * p);
+
+   Node * pRoot;          // the biggest item
+   size_t numElements;    // number of items in the heap
+   Compare compare;       // comparision operator
+   NodeAlloc alloc;       // nodes come from the container's allocator
+};
+
+/*************************************************
+ * PAIRING HEAP NODE
+ *************************************************/
+template <class T, class Compare, class A>
+class pairing_heap <T, Compare, A> :: Node
+{
+public:
+   template <class U>
+   Node(U && u) : data(std::forward<U>(u)),
+      pChild(nullptr), pSibling(nullptr), pPrev(nullptr)
+   {
+   }
+
+   T data;
+   Node * pChild;     // first (left-most) child
+   Node * pSibling;   // next sibling to the right
+   Node * pPrev;      // previous sibling, or the parent if we are the first child
+};
+
+/*************************************************
+ * PAIRING HEAP HANDLE
+ * Returned from push(). Stays valid until that item
+ * is popped or erased.
+ *************************************************/
+template <class T, class Compare, class A>
+class pairing_heap <T, Compare, A> :: handle
+{
+   friend class pairing_heap <T, Compare, A>;
+public:
+   handle() : p(nullptr)
+   {
+   }
+   bool operator == (const handle & rhs) const { return p == rhs.p; }
+   bool operator != (const handle & rhs) const { return p != rhs.p; }
+   const T & operator * () const
+   {
+      return p->data;
+   }
+
+private:
+   handle(Node * p) : p(p)
+   {
+   }
+   Node * p;
+};
+
+/************************************************
+ * PAIRING HEAP :: COPY CONSTRUCTOR
+ * Pushing is O(1), so walking rhs and pushing each
+ * item builds the copy in O(n) without recursion
+ ***********************************************/
+template <class T, class Compare, class A>
+pairing_heap <T, Compare, A> :: pairing_heap(const pairing_heap & rhs) :
+   pRoot(nullptr), numElements(0), compare(rhs.compare),
+   alloc(NodeTraits::select_on_container_copy_construction(rhs.alloc))
+{
+   if (rhs.pRoot == nullptr)
+      return;
+
+   custom::vector <const Node *> pending;
+   pending.push_back(rhs.pRoot);
+   while (pending.size() != 0)
+   {
+      const Node * p = pending.back();
+      pending.pop_back();
+      push(p->data);
+      if (p->pChild)
+         pending.push_back(p->pChild);
+      if (p->pSibling)
+         pending.push_back(p->pSibling);
+   }
+}
+
+/************************************************
+ * PAIRING HEAP :: PUSH
+ * A new item is a heap of one: meld it in
+ *    COST : O(1)
+ ***********************************************/
+template <class T, class Compare, class A>
+typename pairing_heap <T, Compare, A> :: handle
+pairing_heap <T, Compare, A> :: push(const T & t)
+{
+   Node * p = newNode(t);
+   pRoot = link(pRoot, p);
+   numElements++;
+   return handle(p);
+}
+template <class T, class Compare, class A>
+typename pairing_heap <T, Compare, A> :: handle
+pairing_heap <T, Compare, A> :: push(T && t)
+{
+   Node * p = newNode(std::move(t));
+   pRoot = link(pRoot, p);
+   numElements++;
+   return handle(p);
+}
+
+/************************************************
+ * PAIRING HEAP :: MELD
+ * Take every item from rhs, leaving it empty. The
+ * two heaps must share an allocator.
+ *    COST : O(1)
+ ***********************************************/
+template <class T, class Compare, class A>
+void pairing_heap <T, Compare, A> :: meld(pairing_heap & rhs)
+{
+   if (this == &rhs)
+      return;
+   pRoot = link(pRoot, rhs.pRoot);
+   numElements += rhs.numElements;
+   rhs.pRoot = nullptr;
+   rhs.numElements = 0;
+}
+
+/************************************************
+ * PAIRING HEAP :: DECREASE KEY
+ * Move an item toward the top. With std::greater
+ * (smallest first) this is the classic decrease-key.
+ * The item's subtree is cut loose and melded back in.
+ ***********************************************/
+template <class T, class Compare, class A>
+void pairing_heap <T, Compare, A> :: decrease_key(const handle & h, const T & t)
+{
+   Node * p = h.p;
+   assert(p != nullptr);
+   assert(!compare(t, p->data));
+   p->data = t;
+   if (p == pRoot)
+      return;
+   detach(p);
+   pRoot = link(pRoot, p);
+}
+
+/************************************************
+ * PAIRING HEAP :: POP
+ * Remove the top item
+ *    COST : O(log n) amortized
+ ***********************************************/
+template <class T, class Compare, class A>
+void pairing_heap <T, Compare, A> :: pop()
+{
+   if (empty())
+      return;
+   Node * pOld = pRoot;
+   pRoot = combineSiblings(pRoot->pChild);
+   deleteNode(pOld);
+   numElements--;
+}
+
+/************************************************
+ * PAIRING HEAP :: ERASE
+ * Remove any item: cut it out, combine its
+ * children, and meld them back in
+ ***********************************************/
+template <class T, class Compare, class A>
+void pairing_heap <T, Compare, A> :: erase(const handle & h)
+{
+   Node * p = h.p;
+   assert(p != nullptr);
+   if (p == pRoot)
+   {
+      pop();
+      return;
+   }
+   detach(p);
+   pRoot = link(pRoot, combineSiblings(p->pChild));
+   deleteNode(p);
+   numElements--;
+}
+
+/************************************************
+ * PAIRING HEAP :: CLEAR
+ * Free every node. Seen as a binary tree (child on
+ * the left, sibling on the right) we can rotate each
+ * child up until there is none, free the node, and
+ * move on to its sibling: no recursion, no stack.
+ ***********************************************/
+template <class T, class Compare, class A>
+void pairing_heap <T, Compare, A> :: clear()
+{
+   Node * p = pRoot;
+   while (p != nullptr)
+   {
+      if (p->pChild != nullptr)
+      {
+         Node * pChild = p->pChild;
+         p->pChild = pChild->pSibling;
+         pChild->pSibling = p;
+         p = pChild;
+      }
+      else
+      {
+         Node * pNext = p->pSibling;
+         deleteNode(p);
+         p = pNext;
+      }
+   }
+   pRoot = nullptr;
+   numElements = 0;
+}
+
+/************************************************
+ * PAIRING HEAP :: NEW NODE
+ * Allocate and build a node with the allocator
+ ***********************************************/
+template <class T, class Compare, class A>
+template <class U>
+typename pairing_heap <T, Compare, A> :: Node *
+pairing_heap <T, Compare, A> :: newNode(U && u)
+{
+   Node * p = NodeTraits::allocate(alloc, 1);
+   try
+   {
+      NodeTraits::construct(alloc, p, std::forward<U>(u));
+   }
+   catch (...)
+   {
+      NodeTraits::deallocate(alloc, p, 1);
+      throw;
+   }
+   return p;
+}
+
+/************************************************
+ * PAIRING HEAP :: DELETE NODE
+ ***********************************************/
+template <class T, class Compare, class A>
+void pairing_heap <T, Compare, A> :: deleteNode(Node * p)
+{
+   NodeTraits::destroy(alloc, p);
+   NodeTraits::deallocate(alloc, p, 1);
+}
+
+/************************************************
+ * PAIRING HEAP :: LINK
+ * Combine two heaps: the smaller root becomes the
+ * first child of the bigger one
+ ***********************************************/
+template <class T, class Compare, class A>
+typename pairing_heap <T, Compare, A> :: Node *
+pairing_heap <T, Compare, A> :: link(Node * p1, Node * p2) const
+{
+   if (p1 == nullptr)
+      return p2;
+   if (p2 == nullptr)
+      return p1;
+   if (compare(p1->data, p2->data))
+      std::swap(p1, p2);
+
+   p2->pSibling = p1->pChild;
+   if (p1->pChild != nullptr)
+      p1->pChild->pPrev = p2;
+   p2->pPrev = p1;
+   p1->pChild = p2;
+   return p1;
+}
+
+/************************************************
+ * PAIRING HEAP :: COMBINE SIBLINGS
+ * Turn a list of sibling heaps into one. First pass
+ * links them in pairs left to right, stacking each
+ * winner on a list that comes out reversed. Second
+ * pass links that list together, so right to left.
+ ***********************************************/
+template <class T, class Compare, class A>
+typename pairing_heap <T, Compare, A> :: Node *
+pairing_heap <T, Compare, A> :: combineSiblings(Node * pFirst) const
+{
+   if (pFirst == nullptr)
+      return nullptr;
+
+   Node * pPairs = nullptr;
+   while (pFirst != nullptr)
+   {
+      Node * p1 = pFirst;
+      Node * p2 = p1->pSibling;
+      pFirst = (p2 == nullptr) ? nullptr : p2->pSibling;
+
+      p1->pSibling = p1->pPrev = nullptr;
+      if (p2 != nullptr)
+         p2->pSibling = p2->pPrev = nullptr;
+
+      Node * pWinner = link(p1, p2);
+      pWinner->pSibling = pPairs;
+      pPairs = pWinner;
+   }
+
+   Node * pResult = pPairs;
+   pPairs = pPairs->pSibling;
+   pResult->pSibling = nullptr;
+   while (pPairs != nullptr)
+   {
+      Node * p = pPairs;
+      pPairs = p->pSibling;
+      p->pSibling = nullptr;
+      pResult = link(pResult, p);
+   }
+   return pResult;
+}
+
+/************************************************
+ * PAIRING HEAP :: DETACH
+ * Cut a node (and everything below it) out of its
+ * parent's list of children
+ ***********************************************/
+template <class T, class Compare, class A>
+void pairing_heap <T, Compare, A> :: detach(Node * p)
+{
+   assert(p->pPrev != nullptr);
+   if (p->pPrev->pChild == p)
+      p->pPrev->pChild = p->pSibling;
+   else
+      p->pPrev->pSibling = p->pSibling;
+   if (p->pSibling != nullptr)
+      p->pSibling->pPrev = p->pPrev;
+   p->pSibling = p->pPrev = nullptr;
+}
+
+/************************************************
+ * SWAP
+ * Swap the contents of two pairing heaps
+ ************************************************/
+template <class T, class Compare, class A>
+inline void swap(pairing_heap <T, Compare, A> & lhs,
+                 pairing_heap <T, Compare, A> & rhs)
+{
+   lhs.swap(rhs);
+}
+
+};
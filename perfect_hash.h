@@ -0,0 +1,308 @@
+/***********************************************************************
+ * Header:
+ *    PERFECT HASH
+ * Summary:
+ *    A set of keys known at compile time, looked up with one probe
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        static_hash       : A seeded hash that works at compile time
+ *        perfect_hash_set  : A collision-free table over a fixed set of keys
+ * Author
+ *    Tyler and Braeden
+ ************************************************************************/
+
+#pragma once
+
+#include "array.h"     // the keys come in, and the table is, an array
+#include <cstdint>     // for uint64_t
+#include <stdexcept>   // for std::invalid_argument and std::logic_error
+#include <string_view> // for std::string_view
+#include <type_traits> // for std::is_integral and std::is_enum
+
+class TestPerfectHash;      // forward declaration for unit tests
+
+namespace custom
+{
+
+/************************************************
+ * STATIC HASH
+ * std::hash is not constexpr, so the perfect hash
+ * brings its own. Integers and enums are mixed with
+ * the seed; strings use FNV-1a started from the seed.
+ * A custom Hash needs the same constexpr call shape.
+ ************************************************/
+template <typename T>
+struct static_hash
+{
+   static_assert(std::is_integral<T>::value || std::is_enum<T>::value,
+                 "static_hash handles integers, enums and std::string_view");
+
+   constexpr uint64_t operator()(const T& t, uint64_t seed) const
+   {
+      return mix((uint64_t)t ^ seed);
+   }
+
+   // the splitmix64 finalizer
+   static constexpr uint64_t mix(uint64_t h)
+   {
+      h += 0x9E3779B97F4A7C15ull;
+      h = (h ^ (h >> 30)) * 0xBF58476D1CE4E5B9ull;
+      h = (h ^ (h >> 27)) * 0x94D049BB133111EBull;
+      return h ^ (h >> 31);
+   }
+};
+
+template <>
+struct static_hash <std::string_view>
+{
+   constexpr uint64_t operator()(std::string_view s, uint64_t seed) const
+   {
+      uint64_t h = 0xcbf29ce484222325ull ^ seed;
+      for (size_t i = 0; i < s.size(); i++)
+      {
+         h ^= (unsigned char)s[i];
+         h *= 0x100000001b3ull;
+      }
+      return static_hash<uint64_t>::mix(h);
+   }
+};
+
+/************************************************
+ * PERFECT HASH SIZES
+ * The power of two at or above num (at least 2), and
+ * the log of a power of two. Out here rather than in
+ * the class so its static members can use them.
+ ************************************************/
+constexpr size_t perfect_hash_round_up(size_t num)
+{
+   size_t cap = 2;
+   while (cap < num)
+      cap *= 2;
+   return cap;
+}
+constexpr unsigned perfect_hash_log2(size_t num)
+{
+   unsigned bits = 0;
+   while (num > 1)
+   {
+      num /= 2;
+      bits++;
+   }
+   return bits;
+}
+
+/************************************************
+ * PERFECT HASH SET
+ * Hash and displace (CHD). The top half of a key's hash
+ * picks one of about N/4 buckets. Each bucket stores a
+ * displacement, chosen when the set is built, that sends
+ * every key in the bucket to a slot no other key uses.
+ * A lookup is one hash, one displacement and one slot
+ * compare, with no loop and no collision branch.
+ *
+ * The constructor is constexpr, so a set declared
+ * constexpr is built by the compiler. It throws, which
+ * at compile time is an error, on a duplicate key or if
+ * no displacement works for any of a handful of seeds.
+ ************************************************/
+template <typename T, int N, typename Hash = static_hash<T>>
+class perfect_hash_set
+{
+   static_assert(N > 0, "a perfect hash set needs at least one key");
+
+   friend class ::TestPerfectHash;   // give unit tests access to the privates
+
+public:
+   static constexpr size_t numBuckets = (N + 3) / 4;                         // about four keys each
+   static constexpr size_t numSlots   = perfect_hash_round_up(N + (N + 3) / 4); // at most 80% full
+   static constexpr size_t npos       = (size_t)-1;
+
+   //
+   // Construct
+   //
+   constexpr perfect_hash_set(const array<T, N>& keys);
+
+   //
+   // Access
+   //
+   constexpr size_t find(const T& key) const;
+   constexpr bool contains(const T& key) const
+   {
+      return find(key) != npos;
+   }
+   constexpr const T& operator [] (size_t slot) const
+   {
+      return table[slot];
+   }
+
+   //
+   // Status
+   //
+   constexpr size_t size() const       { return N;        }
+   constexpr size_t slot_count() const { return numSlots; }
+
+private:
+   static constexpr unsigned shift = 64 - perfect_hash_log2(numSlots);
+
+   static constexpr size_t bucketOf(uint64_t h)
+   {
+      return (size_t)(((h >> 32) * numBuckets) >> 32);
+   }
+   static constexpr size_t slotOf(uint64_t h, uint64_t displacement)
+   {
+      return (size_t)(((h ^ displacement) * 0x9E3779B97F4A7C15ull) >> shift);
+   }
+   static constexpr uint64_t displacementFor(uint64_t pilot)
+   {
+      return static_hash<uint64_t>::mix(pilot);
+   }
+
+   constexpr bool build(const array<T, N>& keys, uint64_t seed);
+
+   uint64_t seed;                                  // the seed that worked
+   array <uint64_t, (int)numBuckets> displacements; // per bucket
+   array <T,        (int)numSlots>   table;         // the keys, in their slots
+   array <bool,     (int)numSlots>   used;          // which slots hold a key
+};
+
+/*****************************************
+ * PERFECT HASH SET :: CONSTRUCTOR
+ * Try seeds until one gives every bucket a displacement
+ ****************************************/
+template <typename T, int N, typename Hash>
+constexpr perfect_hash_set<T, N, Hash>::perfect_hash_set(const array<T, N>& keys) :
+   seed(0), displacements{}, table{}, used{}
+{
+   for (int i = 0; i < N; i++)
+      for (int j = i + 1; j < N; j++)
+         if (keys[i] == keys[j])
+            throw std::invalid_argument("perfect_hash_set: duplicate key");
+
+   for (uint64_t attempt = 0; attempt < 16; attempt++)
+      if (build(keys, static_hash<uint64_t>::mix(attempt)))
+         return;
+   throw std::logic_error("perfect_hash_set: no perfect hash found");
+}
+
+/*****************************************
+ * PERFECT HASH SET :: FIND
+ * The slot holding key, or npos
+ ****************************************/
+template <typename T, int N, typename Hash>
+constexpr size_t perfect_hash_set<T, N, Hash>::find(const T& key) const
+{
+   uint64_t h = Hash()(key, seed);
+   size_t slot = slotOf(h, displacements[bucketOf(h)]);
+   bool found = used[slot] & (table[slot] == key);
+   return found ? slot : npos;
+}
+
+/*****************************************
+ * PERFECT HASH SET :: BUILD
+ * Group the keys by bucket, then place the biggest
+ * buckets first, while the table is emptiest. For each
+ * bucket, try pilots 0, 1, 2... until the displacement
+ * they give puts each of its keys in a different free
+ * slot. Returns false if some bucket runs out of pilots.
+ ****************************************/
+template <typename T, int N, typename Hash>
+constexpr bool perfect_hash_set<T, N, Hash>::build(const array<T, N>& keys, uint64_t seed)
+{
+   // Hash every key once
+   uint64_t hashes[N] = {};
+   size_t bucketStart[numBuckets + 1] = {};
+   for (int i = 0; i < N; i++)
+   {
+      hashes[i] = Hash()(keys[i], seed);
+      bucketStart[bucketOf(hashes[i]) + 1]++;
+   }
+
+   // Counting sort of the keys by bucket
+   for (size_t b = 0; b < numBuckets; b++)
+      bucketStart[b + 1] += bucketStart[b];
+   int members[N] = {};
+   size_t fill[numBuckets + 1] = {};
+   for (size_t b = 0; b <= numBuckets; b++)
+      fill[b] = bucketStart[b];
+   for (int i = 0; i < N; i++)
+      members[fill[bucketOf(hashes[i])]++] = i;
+
+   // Buckets from biggest to smallest
+   size_t order[numBuckets] = {};
+   for (size_t b = 0; b < numBuckets; b++)
+   {
+      size_t j = b;
+      for (; j > 0 && bucketStart[order[j - 1] + 1] - bucketStart[order[j - 1]] <
+                      bucketStart[b + 1] - bucketStart[b]; j--)
+         order[j] = order[j - 1];
+      order[j] = b;
+   }
+
+   // Place each bucket
+   bool taken[numSlots] = {};
+   uint64_t found[numBuckets] = {};
+   for (size_t k = 0; k < numBuckets; k++)
+   {
+      size_t b = order[k];
+      size_t first = bucketStart[b];
+      size_t last = bucketStart[b + 1];
+      if (first == last)
+         continue;
+
+      bool placed = false;
+      for (uint64_t pilot = 0; pilot < 100000 && !placed; pilot++)
+      {
+         uint64_t displacement = displacementFor(pilot);
+
+         // Take slots as we go, and give them back if one clashes
+         size_t m = first;
+         for (; m < last; m++)
+         {
+            size_t slot = slotOf(hashes[members[m]], displacement);
+            if (taken[slot])
+               break;
+            taken[slot] = true;
+         }
+         if (m == last)
+         {
+            found[b] = displacement;
+            placed = true;
+         }
+         else
+            for (size_t u = first; u < m; u++)
+               taken[slotOf(hashes[members[u]], displacement)] = false;
+      }
+      if (!placed)
+         return false;
+   }
+
+   // It worked: fill in the table
+   this->seed = seed;
+   for (size_t b = 0; b < numBuckets; b++)
+      displacements[b] = found[b];
+   for (int i = 0; i < N; i++)
+   {
+      size_t slot = slotOf(hashes[i], found[bucketOf(hashes[i])]);
+      table[slot] = keys[i];
+      used[slot] = true;
+   }
+   return true;
+}
+
+/*****************************************
+ * MAKE PERFECT HASH SET
+ * Build a set from an array of keys, deducing the types
+ ****************************************/
+template <typename T, int N>
+constexpr perfect_hash_set<T, N> make_perfect_hash_set(const array<T, N>& keys)
+{
+   return perfect_hash_set<T, N>(keys);
+}
+
+}
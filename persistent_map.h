@@ -0,0 +1,726 @@
+/***********************************************************************
+ * Header:
+ *    PERSISTENT MAP
+ * Summary:
+ *    An immutable, path-copying map. Copying one is an O(1) snapshot
+ *    and every update copies only the O(log n) nodes it touches.
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        persistent_map             : A map whose copies are snapshots
+ *        persistent_map::iterator   : An iterator through a snapshot
+ * Author
+ *    Tyler and Braedon
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <atomic>           // for std::atomic
+#include <initializer_list> // for std::initializer_list
+#include <stdexcept>        // for std::out_of_range
+#include <string>           // for std::string
+#include <utility>          // for std::swap
+#include "pair.h"      // for pair
+
+class TestPersistentMap; // forward declaration for unit tests
+
+namespace custom
+{
+
+/*****************************************************************
+ * PERSISTENT MAP
+ * A red-black tree of reference-counted nodes. Snapshots share
+ * every node they have in common. Updates use the same join and
+ * split logic as BST, except a node is copied before it is changed
+ * unless this version holds the only reference to it.
+ *
+ * Take snapshots on the writer's thread (or wherever the map is
+ * published from). After that each snapshot is independent and
+ * can be read on any thread without locking.
+ *****************************************************************/
+template <class K, class V>
+class persistent_map
+{
+   friend class ::TestPersistentMap; // give unit tests access to the privates
+public:
+   using Pairs = custom::pair<K, V>;
+
+   //
+   // Construct
+   //
+   persistent_map() : root(nullptr), numElements(0)
+   {
+   }
+   persistent_map(const persistent_map & rhs) :
+      root(acquire(rhs.root)), numElements(rhs.numElements)
+   {
+   }
+   persistent_map(persistent_map && rhs) :
+      root(rhs.root), numElements(rhs.numElements)
+   {
+      rhs.root = nullptr;
+      rhs.numElements = 0;
+   }
+   template <class Iterator>
+   persistent_map(Iterator first, Iterator last) : persistent_map()
+   {
+      for (; first != last; ++first)
+         insert(*first);
+   }
+   persistent_map(const std::initializer_list <Pairs> & il) : persistent_map()
+   {
+      for (const Pairs & element : il)
+         insert(element);
+   }
+   ~persistent_map()
+   {
+      release(root);
+   }
+
+   //
+   // Assign
+   //
+   persistent_map & operator = (const persistent_map & rhs)
+   {
+      Node * pOld = root;
+      root = acquire(rhs.root);
+      numElements = rhs.numElements;
+      release(pOld);
+      return *this;
+   }
+   persistent_map & operator = (persistent_map && rhs)
+   {
+      swap(rhs);
+      return *this;
+   }
+   void swap(persistent_map & rhs)
+   {
+      std::swap(root, rhs.root);
+      std::swap(numElements, rhs.numElements);
+   }
+
+   // An O(1) read-only copy of the current version
+   persistent_map snapshot() const
+   {
+      return *this;
+   }
+
+   //
+   // Iterator
+   //
+   class iterator;
+   iterator begin() const;
+   iterator end()   const
+   {
+      return iterator();
+   }
+
+   //
+   // Access
+   //
+   iterator find(const K & k) const;
+   const V & at(const K & k) const;
+   size_t count(const K & k) const
+   {
+      return find(k) == end() ? 0 : 1;
+   }
+
+   //
+   // Insert
+   //
+   bool insert(const Pairs & rhs);
+   void insert_or_assign(const K & k, const V & v);
+
+   //
+   // Remove
+   //
+   size_t erase(const K & k);
+   void clear()
+   {
+      release(root);
+      root = nullptr;
+      numElements = 0;
+   }
+
+   //
+   // Status
+   //
+   bool   empty() const noexcept { return numElements == 0; }
+   size_t size()  const noexcept { return numElements;      }
+
+private:
+
+   class Node;
+   Node * root;            // this version's reference to the root
+   size_t numElements;     // number of elements in this version
+
+   // reference counting
+   static Node * acquire(Node * p);
+   static void   release(Node * p);
+   static Node * unshare(Node * p);
+
+   // join-based red-black logic, mirroring BST
+   static int    blackHeight(const Node * p);
+   static Node * rotateLeft (Node * p);
+   static Node * rotateRight(Node * p);
+   static Node * joinRight(Node * pLeft, Node * pMid, Node * pRight, int hLeft, int hRight);
+   static Node * joinLeft (Node * pLeft, Node * pMid, Node * pRight, int hLeft, int hRight);
+   static Node * joinNodes(Node * pLeft, Node * pMid, Node * pRight);
+   static Node * joinNodes(Node * pLeft, Node * pRight);
+   static Node * splitLast(Node * p, Node *& pLast);
+   static void   splitNodes(Node * p, const K & k, Node *& pLeft, Node *& pMid, Node *& pRight);
+};
+
+
+/*****************************************************************
+ * PERSISTENT MAP NODE
+ * A node holds one reference to each of its children. A node may
+ * only be changed by someone who owns its one and only reference.
+ *****************************************************************/
+template <class K, class V>
+class persistent_map <K, V> :: Node
+{
+public:
+   Node(const Pairs & data) : data(data), pLeft(nullptr), pRight(nullptr),
+      isRed(true), refCount(1)
+   {
+   }
+   Node(const Node & rhs) : data(rhs.data), pLeft(acquire(rhs.pLeft)),
+      pRight(acquire(rhs.pRight)), isRed(rhs.isRed), refCount(1)
+   {
+   }
+
+   Pairs data;                       // key and value
+   Node * pLeft;                     // left child - smaller
+   Node * pRight;                    // right child - larger
+   bool isRed;                       // red-black balancing stuff
+   std::atomic <size_t> refCount;    // versions and parents sharing this node
+};
+
+
+/**********************************************************
+ * PERSISTENT MAP ITERATOR
+ * Forward iterator through one snapshot. Keeps the path
+ * back up the tree since the nodes have no parent pointers
+ * (a parent pointer cannot be shared by two versions).
+ * Valid as long as the snapshot it came from is alive.
+ *********************************************************/
+template <class K, class V>
+class persistent_map <K, V> :: iterator
+{
+   friend class ::TestPersistentMap; // give unit tests access to the privates
+   template <class KK, class VV>
+   friend class custom::persistent_map;
+public:
+   // constructors and assignment
+   iterator() : depth(0)
+   {
+   }
+
+   // compare
+   bool operator == (const iterator & rhs) const
+   {
+      return current() == rhs.current();
+   }
+   bool operator != (const iterator & rhs) const
+   {
+      return current() != rhs.current();
+   }
+
+   // de-reference. Read-only: the node may be shared
+   const Pairs & operator * () const
+   {
+      return current()->data;
+   }
+
+   // increment
+   iterator & operator ++ ();
+   iterator   operator ++ (int postfix)
+   {
+      iterator it = *this;
+      ++(*this);
+      return it;
+   }
+
+private:
+   const Node * current() const
+   {
+      return depth == 0 ? nullptr : stack[depth - 1];
+   }
+   void pushLeft(const Node * p)
+   {
+      for (; p != nullptr; p = p->pLeft)
+         stack[depth++] = p;
+   }
+
+   // the current node on top, the ancestors still to be visited below.
+   // A red-black tree of 2^64 nodes is at most 128 deep
+   const Node * stack[128];
+   int depth;
+};
+
+
+/*********************************************
+ * PERSISTENT MAP :: BEGIN
+ * The left-most node of this version
+ ********************************************/
+template <class K, class V>
+typename persistent_map <K, V> :: iterator persistent_map <K, V> :: begin() const
+{
+   iterator it;
+   it.pushLeft(root);
+   return it;
+}
+
+/*********************************************
+ * PERSISTENT MAP :: FIND
+ * Find a key in this version
+ ********************************************/
+template <class K, class V>
+typename persistent_map <K, V> :: iterator persistent_map <K, V> :: find(const K & k) const
+{
+   iterator it;
+   const Node * p = root;
+   while (p != nullptr)
+   {
+      if (k == p->data.first)
+      {
+         it.stack[it.depth++] = p;
+         return it;
+      }
+
+      // only the ancestors we pass on the left are still to come
+      if (k < p->data.first)
+      {
+         it.stack[it.depth++] = p;
+         p = p->pLeft;
+      }
+      else
+         p = p->pRight;
+   }
+   return end();
+}
+
+/*********************************************
+ * PERSISTENT MAP :: AT
+ * Retrieve a value from this version
+ ********************************************/
+template <class K, class V>
+const V & persistent_map <K, V> :: at(const K & k) const
+{
+   iterator it = find(k);
+   if (it == end())
+      throw std::out_of_range(std::string("invalid persistent_map<K, T> key"));
+   return (*it).second;
+}
+
+/*********************************************
+ * PERSISTENT MAP :: INSERT
+ * Add a key that is not already present. Other
+ * versions are unaffected.
+ *    COST : O(log n) new nodes at most
+ ********************************************/
+template <class K, class V>
+bool persistent_map <K, V> :: insert(const Pairs & rhs)
+{
+   // Do not copy a path just to find out nothing changes
+   if (find(rhs.first) != end())
+      return false;
+
+   // Copy the pair before split takes the tree apart, so a
+   // throwing copy leaves this version as it was
+   Node * pNew = new Node(rhs);
+
+   Node * pLeft;
+   Node * pMid;
+   Node * pRight;
+   splitNodes(root, rhs.first, pLeft, pMid, pRight);
+   assert(pMid == nullptr);
+
+   root = joinNodes(pLeft, pNew, pRight);
+   root->isRed = false;
+   numElements++;
+   return true;
+}
+
+/*********************************************
+ * PERSISTENT MAP :: INSERT OR ASSIGN
+ * Add a key or replace its value. Other versions
+ * are unaffected.
+ *    COST : O(log n) new nodes at most
+ ********************************************/
+template <class K, class V>
+void persistent_map <K, V> :: insert_or_assign(const K & k, const V & v)
+{
+   // Build the new node before split takes the tree apart, so a
+   // throwing copy of v leaves this version as it was
+   Node * pNew = new Node(Pairs(k, v));
+
+   Node * pLeft;
+   Node * pMid;
+   Node * pRight;
+   splitNodes(root, k, pLeft, pMid, pRight);
+
+   // The old node, if any, was split out with no children
+   if (pMid != nullptr)
+      release(pMid);
+   else
+      numElements++;
+
+   root = joinNodes(pLeft, pNew, pRight);
+   root->isRed = false;
+}
+
+/*********************************************
+ * PERSISTENT MAP :: ERASE
+ * Remove a key from this version only
+ *    COST : O(log n) new nodes at most
+ ********************************************/
+template <class K, class V>
+size_t persistent_map <K, V> :: erase(const K & k)
+{
+   if (find(k) == end())
+      return 0;
+
+   Node * pLeft;
+   Node * pMid;
+   Node * pRight;
+   splitNodes(root, k, pLeft, pMid, pRight);
+   release(pMid);
+
+   root = joinNodes(pLeft, pRight);
+   if (root != nullptr)
+      root->isRed = false;
+   numElements--;
+   return 1;
+}
+
+/******************************************************
+ ******************************************************
+ ******************************************************
+ ******************* REFERENCE COUNTS *****************
+ ******************************************************
+ ******************************************************
+ ******************************************************/
+
+/*********************************************
+ * PERSISTENT MAP :: ACQUIRE
+ * Take another reference to a node
+ ********************************************/
+template <class K, class V>
+typename persistent_map <K, V> :: Node * persistent_map <K, V> :: acquire(Node * p)
+{
+   if (p != nullptr)
+      p->refCount.fetch_add(1, std::memory_order_relaxed);
+   return p;
+}
+
+/*********************************************
+ * PERSISTENT MAP :: RELEASE
+ * Drop a reference to a node, freeing it (and its
+ * references to its children) if it was the last
+ ********************************************/
+template <class K, class V>
+void persistent_map <K, V> :: release(Node * p)
+{
+   if (p == nullptr || p->refCount.fetch_sub(1, std::memory_order_acq_rel) != 1)
+      return;
+   release(p->pLeft);
+   release(p->pRight);
+   delete p;
+}
+
+/*********************************************
+ * PERSISTENT MAP :: UNSHARE
+ * Given a reference we own, return a node we may
+ * change: the same one if nobody else can see it,
+ * otherwise a copy. This is the path copying.
+ ********************************************/
+template <class K, class V>
+typename persistent_map <K, V> :: Node * persistent_map <K, V> :: unshare(Node * p)
+{
+   if (p == nullptr || p->refCount.load(std::memory_order_acquire) == 1)
+      return p;
+   Node * pCopy = new Node(*p);
+   release(p);
+   return pCopy;
+}
+
+/******************************************************
+ ******************************************************
+ ******************************************************
+ ********************* JOIN / SPLIT *******************
+ ******************************************************
+ ******************************************************
+ ******************************************************/
+
+/*****************************************************
+ * PERSISTENT MAP :: BLACK HEIGHT
+ * Number of black nodes on the path to a leaf
+ ****************************************************/
+template <class K, class V>
+int persistent_map <K, V> :: blackHeight(const Node * p)
+{
+   int height = 0;
+   for (; p != nullptr; p = p->pLeft)
+      if (!p->isRed)
+         height++;
+   return height;
+}
+
+/*****************************************************
+ * PERSISTENT MAP :: ROTATE LEFT
+ * Both p and its right child must be unshared
+ ****************************************************/
+template <class K, class V>
+typename persistent_map <K, V> :: Node * persistent_map <K, V> :: rotateLeft(Node * p)
+{
+   Node * pNew = p->pRight;
+   p->pRight = pNew->pLeft;
+   pNew->pLeft = p;
+   return pNew;
+}
+
+/*****************************************************
+ * PERSISTENT MAP :: ROTATE RIGHT
+ * Both p and its left child must be unshared
+ ****************************************************/
+template <class K, class V>
+typename persistent_map <K, V> :: Node * persistent_map <K, V> :: rotateRight(Node * p)
+{
+   Node * pNew = p->pLeft;
+   p->pLeft = pNew->pRight;
+   pNew->pRight = p;
+   return pNew;
+}
+
+/*****************************************************
+ * PERSISTENT MAP :: JOIN RIGHT
+ * pLeft is taller than pRight: copy our way down the
+ * right spine of pLeft and hang pMid off it
+ ****************************************************/
+template <class K, class V>
+typename persistent_map <K, V> :: Node * persistent_map <K, V> :: joinRight(
+   Node * pLeft, Node * pMid, Node * pRight, int hLeft, int hRight)
+{
+   if ((pLeft == nullptr || !pLeft->isRed) && hLeft == hRight)
+   {
+      pMid->isRed = true;
+      pMid->pLeft = pLeft;
+      pMid->pRight = pRight;
+      return pMid;
+   }
+
+   pLeft = unshare(pLeft);
+   int hChild = hLeft - (pLeft->isRed ? 0 : 1);
+   pLeft->pRight = joinRight(pLeft->pRight, pMid, pRight, hChild, hRight);
+
+   // A black node with two reds below it on the right: rotate.
+   // Both reds were built by this join so they are already unshared
+   if (!pLeft->isRed && pLeft->pRight->isRed &&
+       pLeft->pRight->pRight != nullptr && pLeft->pRight->pRight->isRed)
+   {
+      pLeft->pRight->pRight->isRed = false;
+      return rotateLeft(pLeft);
+   }
+   return pLeft;
+}
+
+/*****************************************************
+ * PERSISTENT MAP :: JOIN LEFT
+ * Mirror image of JOIN RIGHT
+ ****************************************************/
+template <class K, class V>
+typename persistent_map <K, V> :: Node * persistent_map <K, V> :: joinLeft(
+   Node * pLeft, Node * pMid, Node * pRight, int hLeft, int hRight)
+{
+   if ((pRight == nullptr || !pRight->isRed) && hLeft == hRight)
+   {
+      pMid->isRed = true;
+      pMid->pLeft = pLeft;
+      pMid->pRight = pRight;
+      return pMid;
+   }
+
+   pRight = unshare(pRight);
+   int hChild = hRight - (pRight->isRed ? 0 : 1);
+   pRight->pLeft = joinLeft(pLeft, pMid, pRight->pLeft, hLeft, hChild);
+
+   if (!pRight->isRed && pRight->pLeft->isRed &&
+       pRight->pLeft->pLeft != nullptr && pRight->pLeft->pLeft->isRed)
+   {
+      pRight->pLeft->pLeft->isRed = false;
+      return rotateRight(pRight);
+   }
+   return pRight;
+}
+
+/*****************************************************
+ * PERSISTENT MAP :: JOIN NODES
+ * Build one tree out of pLeft < pMid < pRight. Takes
+ * ownership of all three; the returned root may be red.
+ ****************************************************/
+template <class K, class V>
+typename persistent_map <K, V> :: Node * persistent_map <K, V> :: joinNodes(
+   Node * pLeft, Node * pMid, Node * pRight)
+{
+   // Blacken both roots so only pMid can introduce a red-red violation
+   if (pLeft != nullptr && pLeft->isRed)
+   {
+      pLeft = unshare(pLeft);
+      pLeft->isRed = false;
+   }
+   if (pRight != nullptr && pRight->isRed)
+   {
+      pRight = unshare(pRight);
+      pRight->isRed = false;
+   }
+
+   int hLeft = blackHeight(pLeft);
+   int hRight = blackHeight(pRight);
+   Node * pRoot;
+
+   if (hLeft > hRight)
+   {
+      pRoot = joinRight(pLeft, pMid, pRight, hLeft, hRight);
+      if (pRoot->isRed && pRoot->pRight != nullptr && pRoot->pRight->isRed)
+         pRoot->isRed = false;
+   }
+   else if (hRight > hLeft)
+   {
+      pRoot = joinLeft(pLeft, pMid, pRight, hLeft, hRight);
+      if (pRoot->isRed && pRoot->pLeft != nullptr && pRoot->pLeft->isRed)
+         pRoot->isRed = false;
+   }
+   else
+   {
+      pRoot = pMid;
+      pRoot->isRed = true;
+      pRoot->pLeft = pLeft;
+      pRoot->pRight = pRight;
+   }
+   return pRoot;
+}
+
+/*****************************************************
+ * PERSISTENT MAP :: JOIN NODES
+ * Same as above, borrowing the largest node of pLeft
+ * to serve as the middle
+ ****************************************************/
+template <class K, class V>
+typename persistent_map <K, V> :: Node * persistent_map <K, V> :: joinNodes(
+   Node * pLeft, Node * pRight)
+{
+   if (pLeft == nullptr)
+      return pRight;
+
+   Node * pLast = nullptr;
+   pLeft = splitLast(pLeft, pLast);
+   return joinNodes(pLeft, pLast, pRight);
+}
+
+/*****************************************************
+ * PERSISTENT MAP :: SPLIT LAST
+ * Detach the largest node of p into pLast and return
+ * what remains of the tree
+ ****************************************************/
+template <class K, class V>
+typename persistent_map <K, V> :: Node * persistent_map <K, V> :: splitLast(
+   Node * p, Node *& pLast)
+{
+   p = unshare(p);
+   Node * pLeft = p->pLeft;
+   Node * pRight = p->pRight;
+   p->pLeft = p->pRight = nullptr;
+
+   if (pRight == nullptr)
+   {
+      pLast = p;
+      return pLeft;
+   }
+
+   pRight = splitLast(pRight, pLast);
+   return joinNodes(pLeft, p, pRight);
+}
+
+/*****************************************************
+ * PERSISTENT MAP :: SPLIT NODES
+ * Divide p into the keys less than k, the node holding
+ * k if there is one, and the keys greater than k.
+ * Only the nodes along the search path are copied.
+ ****************************************************/
+template <class K, class V>
+void persistent_map <K, V> :: splitNodes(Node * p, const K & k,
+                                         Node *& pLeft, Node *& pMid, Node *& pRight)
+{
+   if (p == nullptr)
+   {
+      pLeft = pMid = pRight = nullptr;
+      return;
+   }
+
+   p = unshare(p);
+   Node * pChildLeft = p->pLeft;
+   Node * pChildRight = p->pRight;
+   p->pLeft = p->pRight = nullptr;
+
+   if (k == p->data.first)
+   {
+      pLeft = pChildLeft;
+      pMid = p;
+      pRight = pChildRight;
+   }
+   else if (k < p->data.first)
+   {
+      splitNodes(pChildLeft, k, pLeft, pMid, pRight);
+      pRight = joinNodes(pRight, p, pChildRight);
+   }
+   else
+   {
+      splitNodes(pChildRight, k, pLeft, pMid, pRight);
+      pLeft = joinNodes(pChildLeft, p, pLeft);
+   }
+}
+
+/*************************************************
+ *************************************************
+ *************************************************
+ ****************** ITERATOR *********************
+ *************************************************
+ *************************************************
+ *************************************************/
+
+/**************************************************
+ * PERSISTENT MAP ITERATOR :: INCREMENT PREFIX
+ * advance by one
+ *************************************************/
+template <class K, class V>
+typename persistent_map <K, V> :: iterator & persistent_map <K, V> :: iterator :: operator ++ ()
+{
+   if (depth == 0)
+      return *this;
+
+   // Done with the current node: its right subtree comes next,
+   // then the ancestor waiting below it on the stack
+   const Node * p = stack[--depth];
+   pushLeft(p->pRight);
+   return *this;
+}
+
+/*****************************************************
+ * SWAP
+ * Swap two persistent maps
+ ****************************************************/
+template <class K, class V>
+void swap(persistent_map <K, V> & lhs, persistent_map <K, V> & rhs)
+{
+   lhs.swap(rhs);
+}
+
+}; // namespace custom
@@ -29,21 +29,26 @@ namespace custom
 
 /*************************************************
  * P QUEUE
- * Create a priority queue.
+ * Create a priority queue. D is the number of children
+ * per node: siblings sit next to each other in the
+ * container, so a 4- or 8-ary heap reads a whole cache
+ * line of children per level and is half or a third as deep.
  *************************************************/
-template<class T, class Container = custom::vector<T>, class Compare = std::less<T>>
+template<class T, class Container = custom::vector<T>, class Compare = std::less<T>, size_t D = 2>
 class priority_queue
 {
+   static_assert(D >= 2, "a heap needs at least two children per node");
+
    friend class ::TestPQueue; // give the unit test class access to the privates
-   template <class TT, class CContainer, class CCompare>
-   friend void swap(priority_queue<TT, CContainer, CCompare>& lhs, priority_queue<TT, CContainer, CCompare>& rhs);
+   template <class TT, class CContainer, class CCompare, size_t DD>
+   friend void swap(priority_queue<TT, CContainer, CCompare, DD>& lhs, priority_queue<TT, CContainer, CCompare, DD>& rhs);
 
 public:
 
    //
    // construct
    //
-   priority_queue(const Compare & c = Compare())
+   priority_queue(const Compare & c = Compare()) : compare(c)
    {
    }
    priority_queue(const priority_queue &  rhs, const Compare & c = Compare()):container(rhs.container),compare(c)
@@ -53,10 +58,12 @@ public:
    {
    }
    template <class Iterator>
-   priority_queue(Iterator first, Iterator last, const Compare & c = Compare()) 
+   priority_queue(Iterator first, Iterator last, const Compare & c = Compare()) : compare(c)
    {
       container.reserve(last-first);
-      for (;first != last; push(*(first++)));
+      for (; first != last; ++first)
+         container.push_back(*first);
+      heapify();
    }
    explicit priority_queue (const Compare& c, Container && rhs):compare(c),container(std::move(rhs))
    {
@@ -80,6 +87,9 @@ public:
    //
    void  push(const T& t);
    void  push(T&& t);     
+   template <class Iterator>
+   void  push_range(Iterator first, Iterator last);
+   void  merge(priority_queue & rhs);
 
    //
    // Remove
@@ -102,6 +112,8 @@ private:
 
    void heapify();                            // convert the container in to a heap
    bool percolateDown(size_t indexHeap);      // fix heap from index down. This is a heap index!
+   void percolateUp(size_t indexHeap);        // fix heap from index up. Also a heap index
+   void repairAppended(size_t numOld);        // fix heap after items were appended past numOld
 
    Container container;       // underlying container (probably a vector)
    Compare   compare;         // comparision operator
@@ -112,8 +124,8 @@ private:
  * P QUEUE :: TOP
  * Get the maximum item from the heap: the top item.
  ***********************************************/
-template <class T, class Container, class Compare>
-const T & priority_queue <T, Container, Compare> :: top() const
+template <class T, class Container, class Compare, size_t D>
+const T & priority_queue <T, Container, Compare, D> :: top() const
 {
    if (empty())
       throw std::out_of_range(std::string("std:out_of_range"));
@@ -124,8 +136,8 @@ const T & priority_queue <T, Container, Compare> :: top() const
  * P QUEUE :: POP
  * Delete the top item from the heap.
  **********************************************/
-template <class T, class Container, class Compare>
-void priority_queue <T, Container, Compare> :: pop()
+template <class T, class Container, class Compare, size_t D>
+void priority_queue <T, Container, Compare, D> :: pop()
 {
    using std::swap;
    if (size() == 0)
@@ -139,79 +151,162 @@ void priority_queue <T, Container, Compare> :: pop()
  * P QUEUE :: PUSH
  * Add a new element to the heap, reallocating as necessary
  ****************************************/
-template <class T, class Container, class Compare>
-void priority_queue <T, Container, Compare> :: push(const T & t)
+template <class T, class Container, class Compare, size_t D>
+void priority_queue <T, Container, Compare, D> :: push(const T & t)
 {
    container.push_back(t);
-   size_t index = size() / 2;
-   while (index && percolateDown(index))
-      index /= 2;
+   percolateUp(size());
 }
-template <class T, class Container, class Compare>
-void priority_queue <T, Container, Compare> :: push(T && t)
+template <class T, class Container, class Compare, size_t D>
+void priority_queue <T, Container, Compare, D> :: push(T && t)
 {
    container.push_back(std::move(t));
-   size_t index = size() / 2;
-   while (index && percolateDown(index))
-      index /= 2;
+   percolateUp(size());
+}
+
+/*****************************************
+ * P QUEUE :: PUSH RANGE
+ * Add a batch of elements. They are all appended
+ * first and the heap repaired once at the end.
+ ****************************************/
+template <class T, class Container, class Compare, size_t D>
+template <class Iterator>
+void priority_queue <T, Container, Compare, D> :: push_range(Iterator first, Iterator last)
+{
+   size_t numOld = size();
+   for (; first != last; ++first)
+      container.push_back(*first);
+   repairAppended(numOld);
+}
+
+/*****************************************
+ * P QUEUE :: MERGE
+ * Move every element of rhs into this heap, leaving
+ * rhs empty. The smaller of the two is the one copied.
+ ****************************************/
+template <class T, class Container, class Compare, size_t D>
+void priority_queue <T, Container, Compare, D> :: merge(priority_queue & rhs)
+{
+   using std::swap;
+   if (this == &rhs)
+      return;
+   if (size() < rhs.size())
+      swap(container, rhs.container);
+
+   size_t numOld = size();
+   for (size_t i = 0; i < rhs.size(); i++)
+      container.push_back(std::move(rhs.container[i]));
+   rhs.container.clear();
+   repairAppended(numOld);
+}
+
+/*****************************************
+ * P QUEUE :: REPAIR APPENDED
+ * Items past numOld were added without regard to the
+ * heap. Sifting each one up costs O(k log n); rebuilding
+ * the whole heap bottom-up costs O(n). Pick the cheaper.
+ ****************************************/
+template <class T, class Container, class Compare, size_t D>
+void priority_queue <T, Container, Compare, D> :: repairAppended(size_t numOld)
+{
+   size_t num = size();
+   size_t numAdded = num - numOld;
+
+   size_t depth = 1;
+   for (size_t n = num; n >= D; n /= D)
+      depth++;
+
+   if (numAdded * depth >= num)
+      heapify();
+   else
+      for (size_t i = numOld + 1; i <= num; i++)
+         percolateUp(i);
 }
 
 /************************************************
  * P QUEUE :: PERCOLATE DOWN
  * The item at the passed index may be out of heap
  * order. Take care of that little detail!
+ * Rather than swapping at every level, the item is
+ * held aside while the larger children move up into
+ * the hole, then it is dropped in once at the end.
  * Return TRUE if anything changed.
  ************************************************/
-template <class T, class Container, class Compare>
-bool priority_queue <T, Container, Compare> :: percolateDown(size_t indexHeap)
+template <class T, class Container, class Compare, size_t D>
+bool priority_queue <T, Container, Compare, D> :: percolateDown(size_t indexHeap)
 {
-   using std::swap;
-   size_t ihLeft = indexHeap * 2;      // Left child heap index
-   size_t ihRight = indexHeap * 2 + 1; // Right child heap index
-   size_t iaLeft = indexHeap * 2 -1;   // Left child array index
-   size_t iaRight = indexHeap * 2;     // Right child array index
-   
+   size_t num = size();
+   size_t iaHole = indexHeap - 1;
+
    // If there are no children, return false
-   if (ihLeft > size())
+   if (iaHole * D + 1 >= num)
       return false;
-   
-   size_t indexBigger;
 
-   // If the right child exists and is greater than the left, update indexBigger
-   if (ihRight <= size() && compare(container[iaLeft], container[iaRight]))
+   T item = std::move(container[iaHole]);
+   for (;;)
    {
-      indexBigger = iaRight;
+      size_t iaFirst = iaHole * D + 1;   // array index of the first child
+      if (iaFirst >= num)
+         break;
+      size_t iaEnd = (num - iaFirst > D) ? iaFirst + D : num;
+
+      // Find the biggest of the children
+      size_t iaBigger = iaFirst;
+      for (size_t ia = iaFirst + 1; ia < iaEnd; ia++)
+         if (compare(container[iaBigger], container[ia]))
+            iaBigger = ia;
+
+      if (!compare(item, container[iaBigger]))
+         break;
+      container[iaHole] = std::move(container[iaBigger]);
+      iaHole = iaBigger;
    }
-   else
-      indexBigger = iaLeft;
-      
-   size_t parentAI = indexHeap - 1;
-   if (compare(container[parentAI], container[indexBigger]))
+   container[iaHole] = std::move(item);
+   return iaHole != indexHeap - 1;
+}
+
+/************************************************
+ * P QUEUE :: PERCOLATE UP
+ * The item at the passed index may be bigger than
+ * its parent. Move the smaller parents down into the
+ * hole until we find where the item belongs.
+ ************************************************/
+template <class T, class Container, class Compare, size_t D>
+void priority_queue <T, Container, Compare, D> :: percolateUp(size_t indexHeap)
+{
+   size_t iaHole = indexHeap - 1;
+   T item = std::move(container[iaHole]);
+   while (iaHole > 0)
    {
-      swap(container[parentAI], container[indexBigger]);
-      percolateDown(indexBigger+1);
-      return true;
+      size_t iaParent = (iaHole - 1) / D;
+      if (!compare(container[iaParent], item))
+         break;
+      container[iaHole] = std::move(container[iaParent]);
+      iaHole = iaParent;
    }
-   return false;
+   container[iaHole] = std::move(item);
 }
 
 /************************************************
  * P QUEUE :: HEAPIFY
  * Turn the container into a heap.
  ************************************************/
-template <class T, class Container, class Compare>
-void priority_queue <T, Container, Compare> ::heapify()
+template <class T, class Container, class Compare, size_t D>
+void priority_queue <T, Container, Compare, D> ::heapify()
 {
-   for (size_t i = size()/2; i > 0; percolateDown(i--));
+   // Start from the parent of the last item: everything after it is a leaf
+   if (size() < 2)
+      return;
+   for (size_t i = (size() - 2) / D + 1; i > 0; percolateDown(i--));
 }
 
 /************************************************
  * SWAP
  * Swap the contents of two priority queues
  ************************************************/
-template <class T, class Container, class Compare>
-inline void swap(custom::priority_queue <T, Container, Compare> & lhs,
-                 custom::priority_queue <T, Container, Compare> & rhs)
+template <class T, class Container, class Compare, size_t D>
+inline void swap(custom::priority_queue <T, Container, Compare, D> & lhs,
+                 custom::priority_queue <T, Container, Compare, D> & rhs)
 {
    std::swap(lhs.container, rhs.container);
    std::swap(lhs.compare, rhs.compare);
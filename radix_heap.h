@@ -0,0 +1,281 @@
+/***********************************************************************
+ * Header:
+ *    RADIX HEAP
+ * Summary:
+ *    A monotone priority queue for unsigned integer keys: the key
+ *    popped never decreases, in exchange for cheap push and pop
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *
+ *    This will contain the class definition of:
+ *        radix_heap          : A smallest-first queue of integer keys
+ * Author
+ *    Tyler and Braedon
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <climits>     // for CHAR_BIT
+#include <stdexcept>   // for std::out_of_range
+#include <string>
+#include <type_traits> // for std::is_unsigned
+#include "pair.h"      // for pair
+#include "vector.h"    // for the buckets
+
+class TestRadixHeap;    // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * RADIX HEAP
+ * Items are kept in buckets by the highest bit in which
+ * their key differs from the last key popped. Bucket 0
+ * holds keys equal to it. When bucket 0 runs dry, the
+ * first non-empty bucket is emptied into the lower ones
+ * around its smallest key. A key moves down at most
+ * once per bit, so push is O(1) and pop is amortized
+ * O(log C) where C is the range of keys.
+ *
+ * Keys pushed must never be smaller than the last key
+ * popped, as with timers or event simulation. Only pop
+ * moves that key; top() finds the smallest key without
+ * rebucketing, so a push after top() may still go below it.
+ *************************************************/
+template <class K, class V>
+class radix_heap
+{
+   static_assert(std::is_unsigned<K>::value, "radix_heap keys must be unsigned integers");
+
+   friend class ::TestRadixHeap; // give the unit test class access to the privates
+
+public:
+   using value_type = custom::pair<K, V>;
+
+   //
+   // construct
+   //
+   radix_heap() : last(0), numElements(0), topBucket(0), topIndex(0)
+   {
+   }
+
+   //
+   // Access
+   //
+   const value_type & top() const;
+
+   //
+   // Insert
+   //
+   void push(const value_type & t);
+   void push(value_type && t);
+   void push(const K & k, const V & v)
+   {
+      push(value_type(k, v));
+   }
+
+   //
+   // Remove
+   //
+   void pop();
+   void clear()
+   {
+      for (size_t i = 0; i < numBuckets; i++)
+         buckets[i].clear();
+      last = 0;
+      numElements = 0;
+      topBucket = 0;
+   }
+
+   //
+   // Status
+   //
+   size_t size() const
+   {
+      return numElements;
+   }
+   bool empty() const
+   {
+      return numElements == 0;
+   }
+
+private:
+
+   static const size_t numBits = sizeof(K) * CHAR_BIT;
+   static const size_t numBuckets = numBits + 1;
+
+   size_t bucketOf(const K & k) const;  // which bucket a key belongs in
+   void   findTop() const;              // the smallest item outside bucket 0
+   void   pull();                       // refill bucket 0
+   void   noteTop(size_t iBucket);      // a push may have a new smallest
+
+   custom::vector <value_type> buckets[numBuckets];
+   K last;                              // the last key popped
+   size_t numElements;                  // number of items in all the buckets
+
+   // Where top() found the smallest item when bucket 0 was empty,
+   // so a second top() or the pop() after it need not look again.
+   // topBucket is 0 when nothing is remembered
+   mutable size_t topBucket;
+   mutable size_t topIndex;
+};
+
+/************************************************
+ * RADIX HEAP :: TOP
+ * The item with the smallest key
+ ***********************************************/
+template <class K, class V>
+const typename radix_heap <K, V> :: value_type & radix_heap <K, V> :: top() const
+{
+   if (empty())
+      throw std::out_of_range(std::string("std:out_of_range"));
+   if (buckets[0].size() != 0)
+      return buckets[0].back();
+   findTop();
+   return buckets[topBucket][topIndex];
+}
+
+/************************************************
+ * RADIX HEAP :: PUSH
+ * Drop an item in its bucket
+ *    COST : O(1)
+ ***********************************************/
+template <class K, class V>
+void radix_heap <K, V> :: push(const value_type & t)
+{
+   assert(!(t.first < last));
+   size_t iBucket = bucketOf(t.first);
+   buckets[iBucket].push_back(t);
+   numElements++;
+   noteTop(iBucket);
+}
+template <class K, class V>
+void radix_heap <K, V> :: push(value_type && t)
+{
+   assert(!(t.first < last));
+   size_t iBucket = bucketOf(t.first);
+   buckets[iBucket].push_back(std::move(t));
+   numElements++;
+   noteTop(iBucket);
+}
+
+/************************************************
+ * RADIX HEAP :: POP
+ * Remove the item with the smallest key
+ *    COST : O(log C) amortized
+ ***********************************************/
+template <class K, class V>
+void radix_heap <K, V> :: pop()
+{
+   if (empty())
+      return;
+   pull();
+   buckets[0].pop_back();
+   numElements--;
+}
+
+/************************************************
+ * RADIX HEAP :: BUCKET OF
+ * One past the highest bit in which k differs from
+ * the last key popped, or 0 if it does not differ
+ ***********************************************/
+template <class K, class V>
+size_t radix_heap <K, V> :: bucketOf(const K & k) const
+{
+   unsigned long long diff = (unsigned long long)(k ^ last);
+   if (diff == 0)
+      return 0;
+#if defined(__GNUC__) || defined(__clang__)
+   return sizeof(unsigned long long) * CHAR_BIT - __builtin_clzll(diff);
+#else
+   size_t iBucket = 0;
+   for (; diff != 0; diff >>= 1)
+      iBucket++;
+   return iBucket;
+#endif
+}
+
+/************************************************
+ * RADIX HEAP :: FIND TOP
+ * Bucket 0 is empty: remember the smallest item in
+ * the first bucket with anything in it
+ ***********************************************/
+template <class K, class V>
+void radix_heap <K, V> :: findTop() const
+{
+   assert(numElements > 0 && buckets[0].size() == 0);
+   if (topBucket != 0)
+      return;
+
+   size_t iBucket = 1;
+   while (buckets[iBucket].size() == 0)
+      iBucket++;
+
+   const custom::vector <value_type> & bucket = buckets[iBucket];
+   size_t iSmallest = 0;
+   for (size_t i = 1; i < bucket.size(); i++)
+      if (bucket[i].first < bucket[iSmallest].first)
+         iSmallest = i;
+   topBucket = iBucket;
+   topIndex = iSmallest;
+}
+
+/************************************************
+ * RADIX HEAP :: NOTE TOP
+ * An item was just pushed into iBucket. If top()
+ * remembered a smallest item, keep it right
+ ***********************************************/
+template <class K, class V>
+void radix_heap <K, V> :: noteTop(size_t iBucket)
+{
+   if (topBucket == 0)
+      return;
+   if (iBucket == 0)
+      topBucket = 0;   // bucket 0 is the top now
+   else if (iBucket < topBucket ||
+            (iBucket == topBucket &&
+             buckets[iBucket].back().first < buckets[topBucket][topIndex].first))
+   {
+      topBucket = iBucket;
+      topIndex = buckets[iBucket].size() - 1;
+   }
+}
+
+/************************************************
+ * RADIX HEAP :: PULL
+ * If bucket 0 is empty, take the first bucket with
+ * anything in it, make its smallest key the new last,
+ * and spread its items over the lower buckets. They
+ * all share the bits above, so they all move down.
+ * The smallest is about to be popped, so last is
+ * again the last key popped.
+ ***********************************************/
+template <class K, class V>
+void radix_heap <K, V> :: pull()
+{
+   assert(numElements > 0);
+   if (buckets[0].size() != 0)
+      return;
+
+   findTop();
+   size_t iBucket = topBucket;
+   custom::vector <value_type> & bucket = buckets[iBucket];
+   last = bucket[topIndex].first;
+   topBucket = 0;
+
+   for (size_t i = 0; i < bucket.size(); i++)
+   {
+      size_t iLower = bucketOf(bucket[i].first);
+      assert(iLower < iBucket);
+      buckets[iLower].push_back(std::move(bucket[i]));
+   }
+   bucket.clear();
+}
+
+};
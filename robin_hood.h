@@ -0,0 +1,781 @@
+/***********************************************************************
+ * Header:
+ *    ROBIN HOOD
+ * Summary:
+ *    Open-addressing hash set and map using Robin Hood probing
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        robin_hood_set           : A hash set with no chains and no tombstones
+ *        robin_hood_set::iterator : An interator through the set
+ *        robin_hood_map           : A hash map built on robin_hood_set
+ * Author
+ *    Tyler and Braeden
+ ************************************************************************/
+
+#pragma once
+
+#include "pair.h"     // for pair
+#include "vector.h"   // because the stash is a vector
+#include <cassert>
+#include <cmath>      // for std::ceil
+#include <cstdint>    // for uint8_t and uint64_t
+#include <cstring>    // for memset
+#include <functional> // for std::hash and std::equal_to
+#include <memory>     // for std::allocator
+#include <new>        // std::bad_alloc
+#include <stdexcept>  // for std::out_of_range and std::length_error
+#include <utility>    // for std::swap
+
+class TestRobinHood;        // forward declaration for unit tests
+
+namespace custom
+{
+template <typename K, typename V, typename Hash, typename EqPred, typename A>
+class robin_hood_map;       // looks keys up in our slots, so it needs the privates
+
+/************************************************
+ * ROBIN HOOD SET
+ * One flat array of slots and a parallel array of
+ * one-byte probe distances. An element lives at or
+ * after its home slot; on insert, an element that is
+ * closer to home than the newcomer gives up its slot,
+ * so distances stay short and even. Erase shifts the
+ * following run back one slot instead of leaving a
+ * tombstone.
+ *
+ * Slots do not wrap around: the array runs past the
+ * last home slot by the longest allowed probe, so an
+ * element only ever moves toward the front on erase.
+ * A probe that would exceed that length puts the
+ * element in a stash of at most four, or once that is
+ * full grows the table, which bounds every lookup.
+ * A home slot is the top bits of the hash, so keys
+ * with one hash share a home at every size and doubling
+ * never spreads their run out. When a sparse table
+ * overflows like that, insert throws std::length_error.
+ ************************************************/
+template <typename T,
+          typename Hash = std::hash<T>,
+          typename EqPred = std::equal_to<T>,
+          typename A = std::allocator<T> >
+class robin_hood_set
+{
+   friend class ::TestRobinHood;   // give unit tests access to the privates
+   template <typename KK, typename VV, typename HH, typename EE, typename AA>
+   friend class custom::robin_hood_map;
+
+   using Traits = std::allocator_traits<A>;
+
+public:
+   //
+   // Construct
+   //
+   robin_hood_set() : robin_hood_set(8)
+   {
+   }
+   robin_hood_set(size_t numBuckets) :
+      slots(nullptr), dists(nullptr), numHome(0), numSlots(0), numElements(0),
+      maxLoadFactor(0.875f)
+   {
+      allocate(roundUp(numBuckets));
+   }
+   robin_hood_set(const robin_hood_set& rhs);
+   robin_hood_set(robin_hood_set&& rhs) : robin_hood_set()
+   {
+      swap(rhs);
+   }
+   template <class Iterator>
+   robin_hood_set(Iterator first, Iterator last) : robin_hood_set()
+   {
+      for (; first != last; ++first)
+         insert(*first);
+   }
+   robin_hood_set(const std::initializer_list<T>& il) : robin_hood_set()
+   {
+      insert(il);
+   }
+   ~robin_hood_set()
+   {
+      clear();
+      deallocate();
+   }
+
+   //
+   // Assign
+   //
+   robin_hood_set& operator = (const robin_hood_set& rhs)
+   {
+      robin_hood_set temp(rhs);
+      swap(temp);
+      return *this;
+   }
+   robin_hood_set& operator = (robin_hood_set&& rhs)
+   {
+      robin_hood_set temp(std::move(rhs));
+      swap(temp);
+      return *this;
+   }
+   robin_hood_set& operator = (const std::initializer_list<T>& il)
+   {
+      clear();
+      insert(il);
+      return *this;
+   }
+   void swap(robin_hood_set& rhs)
+   {
+      std::swap(alloc, rhs.alloc);
+      std::swap(slots, rhs.slots);
+      std::swap(dists, rhs.dists);
+      std::swap(numHome, rhs.numHome);
+      std::swap(numSlots, rhs.numSlots);
+      std::swap(numElements, rhs.numElements);
+      std::swap(maxLoadFactor, rhs.maxLoadFactor);
+      stash.swap(rhs.stash);
+   }
+
+   //
+   // Iterator
+   //
+   class iterator;
+   iterator begin()
+   {
+      iterator it(this, 0);
+      if (*dists == 0)
+         ++it;
+      return it;
+   }
+   iterator end()
+   {
+      return iterator(this, numSlots + stash.size());
+   }
+
+   //
+   // Access
+   //
+   iterator find(const T& t)
+   {
+      return findKey(t);
+   }
+   size_t count(const T& t)
+   {
+      return find(t) == end() ? 0 : 1;
+   }
+
+   //
+   // Insert
+   //
+   custom::pair<iterator, bool> insert(const T& t);
+   custom::pair<iterator, bool> insert(T&& t);
+   void insert(const std::initializer_list<T>& il)
+   {
+      for (auto& t : il)
+         insert(t);
+   }
+   void rehash(size_t numBuckets);
+   void reserve(size_t num)
+   {
+      rehash((size_t)std::ceil(num / maxLoadFactor));
+   }
+
+   //
+   // Remove
+   //
+   void clear() noexcept;
+   size_t erase(const T& t)
+   {
+      iterator it = find(t);
+      if (it == end())
+         return 0;
+      erase(it);
+      return 1;
+   }
+   iterator erase(const iterator& it);
+
+   //
+   // Status
+   //
+   size_t size() const          { return numElements;      }
+   bool empty() const           { return numElements == 0; }
+   size_t bucket_count() const  { return numHome;          }
+   float load_factor() const noexcept
+   {
+      return (float)numElements / (float)numHome;
+   }
+   float max_load_factor() const noexcept
+   {
+      return maxLoadFactor;
+   }
+   void max_load_factor(float m)
+   {
+      // Above 0.95 the runs get long enough to hit the probe limit
+      maxLoadFactor = m > 0.95f ? 0.95f : (m < 0.05f ? 0.05f : m);
+   }
+
+private:
+
+   // Longest stored distance. A stored distance is the probe length
+   // plus one, so that zero can mean the slot is empty.
+   static constexpr unsigned maxDistLimit = 255;
+   static constexpr size_t stashCapacity = 4;
+
+   static size_t roundUp(size_t num)
+   {
+      size_t cap = 8;
+      while (cap < num)
+         cap *= 2;
+      return cap;
+   }
+   unsigned maxDist() const
+   {
+      return numHome < maxDistLimit ? (unsigned)numHome : maxDistLimit;
+   }
+
+   // Fibonacci hashing: the top bits of the product depend on every
+   // bit of the hash, so weak hashes like std::hash<int> spread out
+   template <class Key>
+   size_t home(const Key& key) const
+   {
+      uint64_t h = (uint64_t)Hash()(key) * 0x9E3779B97F4A7C15ull;
+      return (size_t)(h >> shift);
+   }
+
+   template <class Key>
+   iterator findKey(const Key& key);
+   iterator insertNew(T&& t, bool rehashing = false);
+   void allocate(size_t numBuckets);
+   void deallocate();
+
+   A         alloc;           // builds and destroys the elements
+   T *       slots;           // the elements, numSlots of them
+   uint8_t * dists;           // probe distance + 1 for each slot, 0 if empty
+   size_t    numHome;         // slots an element can hash to, a power of two
+   size_t    numSlots;        // numHome plus room to probe past the last one
+   unsigned  shift;           // 64 - log2(numHome)
+   size_t    numElements;     // number of elements in the set
+   float     maxLoadFactor;   // the ratio of elements to buckets signifying a rehash
+   custom::vector<T> stash;   // the few elements past the probe limit
+};
+
+/************************************************
+ * ROBIN HOOD SET ITERATOR
+ * Walks the slots, skipping the empty ones, then the
+ * stash. The distance array has a non-zero sentinel
+ * past the last slot so the skip needs no bounds check.
+ ************************************************/
+template <typename T, typename H, typename E, typename A>
+class robin_hood_set <T, H, E, A> ::iterator
+{
+   friend class ::TestRobinHood;   // give unit tests access to the privates
+   template <typename TT, typename HH, typename EE, typename AA>
+   friend class custom::robin_hood_set;
+public:
+   //
+   // Construct
+   //
+   iterator() : pSet(nullptr), i(0)
+   {
+   }
+   iterator(robin_hood_set* pSet, size_t i) : pSet(pSet), i(i)
+   {
+   }
+
+   //
+   // Compare
+   //
+   bool operator == (const iterator& rhs) const { return i == rhs.i; }
+   bool operator != (const iterator& rhs) const { return i != rhs.i; }
+
+   //
+   // Access
+   //
+   T& operator * ()  { return *get(); }
+   T* operator -> () { return get();  }
+
+   //
+   // Arithmetic
+   //
+   iterator& operator ++ ()
+   {
+      if (i < pSet->numSlots)
+      {
+         do
+            ++i;
+         while (pSet->dists[i] == 0);
+      }
+      else
+         ++i;
+      return *this;
+   }
+   iterator operator ++ (int postfix)
+   {
+      iterator temp(*this);
+      ++(*this);
+      return temp;
+   }
+
+private:
+   T* get() const
+   {
+      if (i < pSet->numSlots)
+         return pSet->slots + i;
+      return &pSet->stash[i - pSet->numSlots];
+   }
+
+   robin_hood_set* pSet;   // the set we walk
+   size_t i;               // slot number, counting on into the stash
+};
+
+/*****************************************
+ * ROBIN HOOD SET :: COPY CONSTRUCTOR
+ * Same size table, every element in the same slot
+ ****************************************/
+template <typename T, typename H, typename E, typename A>
+robin_hood_set<T, H, E, A>::robin_hood_set(const robin_hood_set& rhs) :
+   slots(nullptr), dists(nullptr), numHome(0), numSlots(0), numElements(0),
+   maxLoadFactor(rhs.maxLoadFactor), stash(rhs.stash)
+{
+   allocate(rhs.numHome);
+   numElements = stash.size();
+   for (size_t i = 0; i < numSlots; i++)
+      if (rhs.dists[i])
+      {
+         Traits::construct(alloc, slots + i, rhs.slots[i]);
+         dists[i] = rhs.dists[i];
+         numElements++;
+      }
+}
+
+/*****************************************
+ * ROBIN HOOD SET :: INSERT
+ * Insert one element if it is not already here
+ ****************************************/
+template <typename T, typename H, typename E, typename A>
+custom::pair<typename robin_hood_set<T, H, E, A>::iterator, bool>
+robin_hood_set<T, H, E, A>::insert(const T& t)
+{
+   iterator it = find(t);
+   if (it != end())
+      return custom::pair<iterator, bool>(it, false);
+   T copy(t);
+   return custom::pair<iterator, bool>(insertNew(std::move(copy)), true);
+}
+template <typename T, typename H, typename E, typename A>
+custom::pair<typename robin_hood_set<T, H, E, A>::iterator, bool>
+robin_hood_set<T, H, E, A>::insert(T&& t)
+{
+   iterator it = find(t);
+   if (it != end())
+      return custom::pair<iterator, bool>(it, false);
+   return custom::pair<iterator, bool>(insertNew(std::move(t)), true);
+}
+
+/*****************************************
+ * ROBIN HOOD SET :: ERASE
+ * Remove the element at it by sliding every element
+ * after it that is away from home back one slot.
+ * The next element, if any, is now at it or after.
+ * In the stash, the last element fills the hole.
+ ****************************************/
+template <typename T, typename H, typename E, typename A>
+typename robin_hood_set<T, H, E, A>::iterator
+robin_hood_set<T, H, E, A>::erase(const iterator& it)
+{
+   if (it == end())
+      return it;
+
+   size_t i = it.i;
+   if (i >= numSlots)
+   {
+      size_t iStash = i - numSlots;
+      if (iStash + 1 != stash.size())
+         stash[iStash] = std::move(stash.back());
+      stash.pop_back();
+      numElements--;
+      return iterator(this, i);
+   }
+
+   size_t j = i + 1;
+   for (; dists[j] > 1; j++)
+   {
+      slots[j - 1] = std::move(slots[j]);
+      dists[j - 1] = dists[j] - 1;
+   }
+   Traits::destroy(alloc, slots + j - 1);
+   dists[j - 1] = 0;
+   numElements--;
+
+   iterator itNext(this, i);
+   if (dists[i] == 0)
+      ++itNext;
+   return itNext;
+}
+
+/*****************************************
+ * ROBIN HOOD SET :: CLEAR
+ * Destroy every element but keep the slots
+ ****************************************/
+template <typename T, typename H, typename E, typename A>
+void robin_hood_set<T, H, E, A>::clear() noexcept
+{
+   for (size_t i = 0; i < numSlots; i++)
+      if (dists[i])
+      {
+         Traits::destroy(alloc, slots + i);
+         dists[i] = 0;
+      }
+   stash.clear();
+   numElements = 0;
+}
+
+/*****************************************
+ * ROBIN HOOD SET :: REHASH
+ * Grow to at least numBuckets home slots and put
+ * every element, stash included, in its new place
+ ****************************************/
+template <typename T, typename H, typename E, typename A>
+void robin_hood_set<T, H, E, A>::rehash(size_t numBuckets)
+{
+   // If already more buckets, return
+   if (numBuckets <= bucket_count())
+      return;
+
+   // Take the old slots and stash aside and start over with empty ones
+   T * slotsOld = slots;
+   uint8_t * distsOld = dists;
+   size_t numSlotsOld = numSlots;
+   custom::vector<T> stashOld;
+   stashOld.swap(stash);
+   allocate(roundUp(numBuckets));
+   numElements = 0;
+
+   // Move each element across. One past the probe limit goes in the
+   // stash even when it is full; throwing here would lose elements
+   for (size_t i = 0; i < numSlotsOld; i++)
+      if (distsOld[i])
+      {
+         insertNew(std::move(slotsOld[i]), true /*rehashing*/);
+         Traits::destroy(alloc, slotsOld + i);
+      }
+   for (size_t i = 0; i < stashOld.size(); i++)
+      insertNew(std::move(stashOld[i]), true /*rehashing*/);
+
+   Traits::deallocate(alloc, slotsOld, numSlotsOld);
+   delete [] distsOld;
+}
+
+/*****************************************
+ * ROBIN HOOD SET :: FIND KEY
+ * Find an element by anything Hash and EqPred accept
+ * alongside T. The search stops at the first slot whose
+ * element is closer to home than we are: ours would
+ * have taken that slot. Then the stash, if in use.
+ ****************************************/
+template <typename T, typename H, typename E, typename A>
+template <class Key>
+typename robin_hood_set<T, H, E, A>::iterator
+robin_hood_set<T, H, E, A>::findKey(const Key& key)
+{
+   size_t i = home(key);
+   for (unsigned dist = 1; dists[i] >= dist; i++, dist++)
+      if (dists[i] == dist && E()(slots[i], key))
+         return iterator(this, i);
+   for (size_t iStash = 0; iStash < stash.size(); iStash++)
+      if (E()(stash[iStash], key))
+         return iterator(this, numSlots + iStash);
+   return end();
+}
+
+/*****************************************
+ * ROBIN HOOD SET :: INSERT NEW
+ * Add an element the caller knows is not already here.
+ * It goes in the first slot whose element is closer to
+ * home than it would be; that element and the rest of
+ * its run move up one slot, each a step further from
+ * home. If the table is too full, grow first. If that
+ * would push any of them past the probe limit, stash t
+ * when the stash has room, else grow, unless the table
+ * is sparse already. A rehash only moves elements that
+ * were in the set, so it stashes them past the limit.
+ ****************************************/
+template <typename T, typename H, typename E, typename A>
+typename robin_hood_set<T, H, E, A>::iterator
+robin_hood_set<T, H, E, A>::insertNew(T&& t, bool rehashing)
+{
+   for (;;)
+   {
+      if ((float)(numElements + 1) > maxLoadFactor * (float)numHome)
+      {
+         rehash(numHome * 2);
+         continue;
+      }
+
+      // Find where t belongs
+      size_t i = home(t);
+      unsigned dist = 1;
+      for (; dists[i] >= dist; i++)
+         dist++;
+
+      // and the empty slot that ends the run from there
+      unsigned limit = maxDist();
+      bool fits = dist <= limit;
+      size_t iEmpty = i;
+      for (; fits && iEmpty < numSlots && dists[iEmpty]; iEmpty++)
+         fits = dists[iEmpty] < limit;
+      if (!fits || iEmpty == numSlots)
+      {
+         if (stash.size() < stashCapacity || rehashing)
+         {
+            stash.push_back(std::move(t));
+            numElements++;
+            return iterator(this, numSlots + stash.size() - 1);
+         }
+
+         // A run of maxDist elements in a table at most a quarter
+         // full is a pile of equal hashes, not bad luck
+         if (load_factor() < 0.25f)
+            throw std::length_error("robin_hood_set: too many keys with one hash");
+         rehash(numHome * 2);
+         continue;
+      }
+
+      // Open up slot i by moving the run up one
+      if (iEmpty > i)
+      {
+         Traits::construct(alloc, slots + iEmpty, std::move(slots[iEmpty - 1]));
+         for (size_t j = iEmpty - 1; j > i; j--)
+            slots[j] = std::move(slots[j - 1]);
+         for (size_t j = iEmpty; j > i; j--)
+            dists[j] = dists[j - 1] + 1;
+         slots[i] = std::move(t);
+      }
+      else
+         Traits::construct(alloc, slots + i, std::move(t));
+      dists[i] = (uint8_t)dist;
+      numElements++;
+      return iterator(this, i);
+   }
+}
+
+/*****************************************
+ * ROBIN HOOD SET :: ALLOCATE and DEALLOCATE
+ * Get empty slots for numBuckets homes. The distance
+ * array gets one extra entry, a non-zero sentinel.
+ ****************************************/
+template <typename T, typename H, typename E, typename A>
+void robin_hood_set<T, H, E, A>::allocate(size_t numBuckets)
+{
+   numHome = numBuckets;
+   numSlots = numHome + maxDist() - 1;
+   shift = 64;
+   for (size_t n = numHome; n > 1; n /= 2)
+      shift--;
+   slots = Traits::allocate(alloc, numSlots);
+   dists = new uint8_t[numSlots + 1];
+   memset(dists, 0, numSlots);
+   dists[numSlots] = 1;
+}
+template <typename T, typename H, typename E, typename A>
+void robin_hood_set<T, H, E, A>::deallocate()
+{
+   if (slots)
+      Traits::deallocate(alloc, slots, numSlots);
+   delete [] dists;
+   slots = nullptr;
+   dists = nullptr;
+}
+
+/*****************************************
+ * SWAP
+ * Stand-alone robin hood set swap
+ ****************************************/
+template <typename T, typename H, typename E, typename A>
+void swap(robin_hood_set<T, H, E, A>& lhs, robin_hood_set<T, H, E, A>& rhs)
+{
+   lhs.swap(rhs);
+}
+
+/************************************************
+ * ROBIN HOOD MAP
+ * A robin_hood_set of pairs that hashes and compares
+ * only the key, the same way unordered_map sits on
+ * unordered_set
+ ************************************************/
+template <typename K,
+          typename V,
+          typename Hash = std::hash<K>,
+          typename EqPred = std::equal_to<K>,
+          typename A = std::allocator<custom::pair<K, V>> >
+class robin_hood_map
+{
+   friend class ::TestRobinHood;   // give unit tests access to the privates
+public:
+   using Pairs = custom::pair<K, V>;
+
+private:
+   // Hash and compare a pair by its key, or a bare key against a pair
+   struct KeyHash
+   {
+      size_t operator()(const Pairs& p) const { return Hash()(p.first); }
+      size_t operator()(const K& k)     const { return Hash()(k);       }
+   };
+   struct KeyEq
+   {
+      bool operator()(const Pairs& lhs, const Pairs& rhs) const { return EqPred()(lhs.first, rhs.first); }
+      bool operator()(const Pairs& lhs, const K& k)       const { return EqPred()(lhs.first, k);         }
+   };
+   using Table = robin_hood_set<Pairs, KeyHash, KeyEq, A>;
+
+public:
+   using iterator = typename Table::iterator;
+
+   //
+   // Construct
+   //
+   robin_hood_map()
+   {
+   }
+   robin_hood_map(size_t numBuckets) : table(numBuckets)
+   {
+   }
+   template <class Iterator>
+   robin_hood_map(Iterator first, Iterator last)
+   {
+      for (; first != last; ++first)
+         insert(*first);
+   }
+   robin_hood_map(const std::initializer_list<Pairs>& il)
+   {
+      insert(il);
+   }
+
+   //
+   // Assign
+   //
+   void swap(robin_hood_map& rhs)
+   {
+      table.swap(rhs.table);
+   }
+
+   //
+   // Iterator
+   //
+   iterator begin() { return table.begin(); }
+   iterator end()   { return table.end();   }
+
+   //
+   // Access
+   //
+   V& operator [] (const K& k)
+   {
+      iterator it = find(k);
+      if (it == end())
+         it = table.insertNew(Pairs(k));
+      return it->second;
+   }
+   V& at(const K& k)
+   {
+      iterator it = find(k);
+      if (it == end())
+         throw std::out_of_range("invalid robin_hood_map<K, T> key");
+      return it->second;
+   }
+   iterator find(const K& k)
+   {
+      return table.findKey(k);
+   }
+   size_t count(const K& k)
+   {
+      return find(k) == end() ? 0 : 1;
+   }
+
+   //
+   // Insert
+   //
+   custom::pair<iterator, bool> insert(const Pairs& rhs)
+   {
+      return table.insert(rhs);
+   }
+   custom::pair<iterator, bool> insert(Pairs&& rhs)
+   {
+      return table.insert(std::move(rhs));
+   }
+   void insert(const std::initializer_list<Pairs>& il)
+   {
+      for (auto& rhs : il)
+         insert(rhs);
+   }
+   template <class... Args>
+   custom::pair<iterator, bool> try_emplace(const K& k, Args&&... args)
+   {
+      iterator it = find(k);
+      if (it != end())
+         return custom::pair<iterator, bool>(it, false);
+      it = table.insertNew(Pairs(k, V(std::forward<Args>(args)...)));
+      return custom::pair<iterator, bool>(it, true);
+   }
+   template <class M>
+   custom::pair<iterator, bool> insert_or_assign(const K& k, M&& m)
+   {
+      iterator it = find(k);
+      if (it != end())
+      {
+         it->second = std::forward<M>(m);
+         return custom::pair<iterator, bool>(it, false);
+      }
+      it = table.insertNew(Pairs(k, V(std::forward<M>(m))));
+      return custom::pair<iterator, bool>(it, true);
+   }
+   void reserve(size_t num)        { table.reserve(num);        }
+   void rehash(size_t numBuckets)  { table.rehash(numBuckets);  }
+
+   //
+   // Remove
+   //
+   void clear() noexcept
+   {
+      table.clear();
+   }
+   size_t erase(const K& k)
+   {
+      iterator it = find(k);
+      if (it == end())
+         return 0;
+      table.erase(it);
+      return 1;
+   }
+   iterator erase(const iterator& it)
+   {
+      return table.erase(it);
+   }
+
+   //
+   // Status
+   //
+   size_t size() const                { return table.size();            }
+   bool empty() const                 { return table.empty();           }
+   size_t bucket_count() const        { return table.bucket_count();    }
+   float load_factor() const noexcept { return table.load_factor();     }
+   float max_load_factor() const      { return table.max_load_factor(); }
+   void  max_load_factor(float m)     { table.max_load_factor(m);       }
+
+private:
+   Table table;   // the pairs, hashed on their keys
+};
+
+/*****************************************
+ * SWAP
+ * Stand-alone robin hood map swap
+ ****************************************/
+template <typename K, typename V, typename H, typename E, typename A>
+void swap(robin_hood_map<K, V, H, E, A>& lhs, robin_hood_map<K, V, H, E, A>& rhs)
+{
+   lhs.swap(rhs);
+}
+
+}
@@ -182,11 +182,48 @@ namespace custom
          //Insert elements until the end is reached
          while (itBegin != itEnd)
          {
-            itBegin = erase(temp);
+            itBegin = erase(itBegin);
          }
          return itEnd;
       }
 
+      //
+      // Node Handles: move elements between sets without reallocating
+      //
+      using node_type = typename custom::BST<T>::node_type;
+      node_type extract(const iterator& it)
+      {
+         return bst.extract(it.it);
+      }
+      node_type extract(const T& t)
+      {
+         return bst.extract(bst.find(t));
+      }
+      std::pair<iterator, bool> insert(node_type&& nh)
+      {
+         return bst.insert(std::move(nh), true);
+      }
+      void merge(set& rhs)
+      {
+         bst.merge(rhs.bst, true);
+      }
+
+      //
+      // Set Algebra: rhs is consumed and its nodes are reused
+      //
+      void set_union(set& rhs, bool parallel = false)
+      {
+         bst.set_union(rhs.bst, parallel);
+      }
+      void set_intersection(set& rhs, bool parallel = false)
+      {
+         bst.set_intersection(rhs.bst, parallel);
+      }
+      void set_difference(set& rhs, bool parallel = false)
+      {
+         bst.set_difference(rhs.bst, parallel);
+      }
+
    private:
 
       custom::BST <T> bst;
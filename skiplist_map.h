@@ -0,0 +1,662 @@
+/***********************************************************************
+ * Header:
+ *    SKIPLIST MAP
+ * Summary:
+ *    An ordered map that many threads can read while one writes,
+ *    with no lock on the read side
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *
+ *    This will contain the class definition of:
+ *        skiplist_map            : A concurrent ordered map
+ *        skiplist_map::iterator  : An iterator that keeps its nodes alive
+ * Author
+ *    Tyler and Braedon
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <atomic>           // for std::atomic
+#include <cstdint>          // for uint64_t
+#include <functional>       // for std::less and std::hash
+#include <memory>           // for std::unique_ptr
+#include <mutex>            // for std::mutex
+#include <new>              // for placement new
+#include <stdexcept>        // for std::out_of_range
+#include <thread>           // for std::thread::hardware_concurrency
+#include "pair.h"           // for pair
+#include "vector.h"         // for the retired list
+
+class TestSkiplistMap;   // forward declaration for unit test class
+
+namespace custom
+{
+
+/*************************************************
+ * SKIPLIST MAP
+ * A skip list whose links are atomic. Readers
+ * (find, lower_bound, iteration) take no lock: they
+ * follow the links with acquire loads. Writers take
+ * one mutex, so there is never more than one, and
+ * publish each change with a release store, so a
+ * reader sees a node only once it is fully built.
+ *
+ * An erased node cannot be freed at once, since a
+ * reader may be standing on it. Instead it is
+ * retired with the current epoch, and freed once
+ * every reader active at that time has finished.
+ * Each reader announces the epoch it started in
+ * through a guard; iterators hold one, so a node
+ * stays valid for as long as an iterator is on it.
+ * Guards share slots, each slot counting its guards,
+ * so there is no limit on how many may be held.
+ *
+ * A value is never changed in place: assigning to
+ * a key splices in a new node and retires the old.
+ *************************************************/
+template <class K, class V, class Compare = std::less<K>>
+class skiplist_map
+{
+   friend class ::TestSkiplistMap; // give the unit test class access to the privates
+
+   static const int maxLevel = 16;   // enough for 4^16 elements at p = 1/4
+
+   struct Node;
+   class Guard;
+
+public:
+   using Pairs = custom::pair<K, V>;
+
+   //
+   // construct
+   //
+   skiplist_map(const Compare & c = Compare());
+   skiplist_map(const skiplist_map & rhs) = delete;
+   skiplist_map & operator = (const skiplist_map & rhs) = delete;
+   ~skiplist_map();
+
+   //
+   // Iterator
+   //
+   class iterator;
+   iterator begin() const;
+   iterator end() const
+   {
+      return iterator();
+   }
+
+   //
+   // Access. Safe on any thread at any time
+   //
+   iterator find(const K & k) const;
+   iterator lower_bound(const K & k) const;
+   bool contains(const K & k) const
+   {
+      return find(k) != end();
+   }
+   size_t count(const K & k) const
+   {
+      return contains(k) ? 1 : 0;
+   }
+   V at(const K & k) const;   // a copy, since the node may be replaced
+
+   //
+   // Insert. Writers take turns
+   //
+   custom::pair<iterator, bool> insert(const Pairs & rhs);
+   custom::pair<iterator, bool> insert_or_assign(const K & k, const V & v);
+
+   //
+   // Remove
+   //
+   size_t erase(const K & k);
+   void clear();
+
+   //
+   // Status. Only a snapshot while a writer is busy
+   //
+   size_t size() const
+   {
+      return numElements.load(std::memory_order_relaxed);
+   }
+   bool empty() const
+   {
+      return size() == 0;
+   }
+
+private:
+
+   // The pair, and a tower of height links sized when allocated
+   struct Node
+   {
+      Node(const K & k, const V & v, int height) : data(k, v), height(height)
+      {
+      }
+      Pairs data;
+      int height;
+      std::atomic <Node *> next[1];   // really next[height]
+   };
+
+   // Where readers say which epoch they started in: the epoch above
+   // a count of the guards sharing the slot, or 0 when unused. Each
+   // gets its own cache line so readers do not slow each other down
+   static const int countBits = 24;
+   static const uint64_t countMask = ((uint64_t)1 << countBits) - 1;
+   struct alignas(64) Slot
+   {
+      Slot() : state(0)
+      {
+      }
+      std::atomic <uint64_t> state;
+   };
+
+   // A node waiting for the readers that might see it to finish
+   struct Retired
+   {
+      Node * pNode;
+      uint64_t epoch;
+   };
+
+   static Node * allocate(const K & k, const V & v, int height);
+   static void deallocate(Node * pNode);
+
+   std::atomic <Node *> * linksOf(Node * pNode) const
+   {
+      return pNode ? pNode->next : const_cast<std::atomic <Node *> *>(head);
+   }
+   Node * findPreds(const K & k, Node * preds[maxLevel]) const;
+   Node * link(const K & k, const V & v, Node * preds[maxLevel]);
+   int randomHeight();
+   void retire(Node * pNode);
+   void reclaim();
+
+   std::atomic <Node *> head[maxLevel];   // the links out of the front
+   std::unique_ptr <Slot[]> slots;        // shared by the readers
+   size_t numSlots;                       // how many slots
+   std::atomic <uint64_t> epoch;          // bumped each time a node is retired
+   std::atomic <size_t> numElements;      // pairs in the map
+   std::mutex writer;                     // held by whoever is changing the map
+   custom::vector <Retired> retired;      // unlinked, not yet freed; writer only
+   uint64_t seed;                         // for tower heights; writer only
+   Compare compare;                       // comparision operator
+};
+
+/************************************************
+ * SKIPLIST MAP :: GUARD
+ * Holds a share of a slot for as long as it lives.
+ * Nothing retired in the slot's epoch or later is
+ * freed until it is gone. A copy shares the slot,
+ * and so the epoch, of the guard it copies.
+ ***********************************************/
+template <class K, class V, class Compare>
+class skiplist_map <K, V, Compare> :: Guard
+{
+public:
+   Guard() : pSlot(nullptr)
+   {
+   }
+   Guard(const skiplist_map * pMap) : pSlot(nullptr)
+   {
+      claim(pMap);
+   }
+   Guard(const Guard & rhs) : pSlot(rhs.pSlot)
+   {
+      if (pSlot)
+         pSlot->state.fetch_add(1);
+   }
+   Guard & operator = (const Guard & rhs)
+   {
+      // Join first, in case we are the last guard on the same slot
+      if (rhs.pSlot)
+         rhs.pSlot->state.fetch_add(1);
+      release();
+      pSlot = rhs.pSlot;
+      return *this;
+   }
+   ~Guard()
+   {
+      release();
+   }
+
+private:
+   // Take an idle slot at the current epoch, starting from one picked
+   // by thread so threads mostly use their own. If every slot is busy,
+   // share that one: its epoch is no later than now, so it covers us too
+   void claim(const skiplist_map * pMap)
+   {
+      size_t i = std::hash<std::thread::id>()(std::this_thread::get_id()) % pMap->numSlots;
+      for (size_t probe = 0; probe < pMap->numSlots; probe++)
+      {
+         Slot & slot = pMap->slots[(i + probe) % pMap->numSlots];
+         uint64_t idle = 0;
+         if (slot.state.load(std::memory_order_relaxed) == 0 &&
+             slot.state.compare_exchange_strong(idle, (pMap->epoch.load() << countBits) | 1))
+         {
+            pSlot = &slot;
+            return;
+         }
+      }
+
+      Slot & slot = pMap->slots[i];
+      uint64_t state = slot.state.load();
+      for (;;)
+      {
+         uint64_t next = state == 0 ? (pMap->epoch.load() << countBits) | 1 : state + 1;
+         assert((state & countMask) != countMask);
+         if (slot.state.compare_exchange_weak(state, next))
+            break;
+      }
+      pSlot = &slot;
+   }
+
+   // The last guard out marks the slot unused
+   void release()
+   {
+      if (pSlot)
+      {
+         uint64_t state = pSlot->state.load(std::memory_order_relaxed);
+         for (;;)
+         {
+            uint64_t next = (state & countMask) == 1 ? 0 : state - 1;
+            if (pSlot->state.compare_exchange_weak(state, next, std::memory_order_release,
+                                                   std::memory_order_relaxed))
+               break;
+         }
+      }
+      pSlot = nullptr;
+   }
+
+   Slot * pSlot;   // the slot we share, if any
+};
+
+/**************************************************
+ * SKIPLIST MAP ITERATOR
+ * Walks the bottom level. Its guard keeps the node
+ * it is on, and every node after it, from being
+ * freed, so it may be used while the writer works.
+ * It sees the map as it is when it gets there:
+ * it may or may not see changes made ahead of it.
+ *************************************************/
+template <class K, class V, class Compare>
+class skiplist_map <K, V, Compare> :: iterator
+{
+   friend class ::TestSkiplistMap;
+   friend class skiplist_map;
+public:
+   //
+   // Construct
+   //
+   iterator() : pNode(nullptr)
+   {
+   }
+
+   //
+   // Compare
+   //
+   bool operator == (const iterator & rhs) const
+   {
+      return pNode == rhs.pNode;
+   }
+   bool operator != (const iterator & rhs) const
+   {
+      return pNode != rhs.pNode;
+   }
+
+   //
+   // Access
+   //
+   const Pairs & operator * () const
+   {
+      return pNode->data;
+   }
+
+   //
+   // Increment
+   //
+   iterator & operator ++ ()
+   {
+      pNode = pNode->next[0].load(std::memory_order_acquire);
+      return *this;
+   }
+   iterator operator ++ (int postfix)
+   {
+      iterator old(*this);
+      ++*this;
+      return old;
+   }
+
+private:
+   iterator(const Guard & guard, Node * pNode) : guard(guard), pNode(pNode)
+   {
+   }
+
+   Guard guard;    // keeps pNode alive
+   Node * pNode;   // the current pair, or null at the end
+};
+
+/************************************************
+ * SKIPLIST MAP :: CONSTRUCTOR
+ * A few reader slots for every thread the machine can run
+ ***********************************************/
+template <class K, class V, class Compare>
+skiplist_map <K, V, Compare> :: skiplist_map(const Compare & c) :
+   epoch(1), numElements(0), seed(0x9E3779B97F4A7C15ull), compare(c)
+{
+   for (int i = 0; i < maxLevel; i++)
+      head[i].store(nullptr, std::memory_order_relaxed);
+
+   size_t numThreads = std::thread::hardware_concurrency();
+   numSlots = 4 * (numThreads == 0 ? 1 : numThreads);
+   if (numSlots < 16)
+      numSlots = 16;
+   slots.reset(new Slot[numSlots]);
+}
+
+/************************************************
+ * SKIPLIST MAP :: DESTRUCTOR
+ * No readers may be left, so free everything
+ ***********************************************/
+template <class K, class V, class Compare>
+skiplist_map <K, V, Compare> :: ~skiplist_map()
+{
+   Node * pNode = head[0].load(std::memory_order_relaxed);
+   while (pNode)
+   {
+      Node * pNext = pNode->next[0].load(std::memory_order_relaxed);
+      deallocate(pNode);
+      pNode = pNext;
+   }
+   for (size_t i = 0; i < retired.size(); i++)
+      deallocate(retired[i].pNode);
+}
+
+/************************************************
+ * SKIPLIST MAP :: BEGIN
+ ***********************************************/
+template <class K, class V, class Compare>
+typename skiplist_map <K, V, Compare> :: iterator
+skiplist_map <K, V, Compare> :: begin() const
+{
+   Guard guard(this);
+   return iterator(guard, head[0].load(std::memory_order_acquire));
+}
+
+/************************************************
+ * SKIPLIST MAP :: FIND
+ ***********************************************/
+template <class K, class V, class Compare>
+typename skiplist_map <K, V, Compare> :: iterator
+skiplist_map <K, V, Compare> :: find(const K & k) const
+{
+   Guard guard(this);
+   Node * pNode = findPreds(k, nullptr);
+   if (pNode && !compare(k, pNode->data.first))
+      return iterator(guard, pNode);
+   return end();
+}
+
+/************************************************
+ * SKIPLIST MAP :: LOWER BOUND
+ ***********************************************/
+template <class K, class V, class Compare>
+typename skiplist_map <K, V, Compare> :: iterator
+skiplist_map <K, V, Compare> :: lower_bound(const K & k) const
+{
+   Guard guard(this);
+   Node * pNode = findPreds(k, nullptr);
+   return pNode ? iterator(guard, pNode) : end();
+}
+
+/************************************************
+ * SKIPLIST MAP :: AT
+ ***********************************************/
+template <class K, class V, class Compare>
+V skiplist_map <K, V, Compare> :: at(const K & k) const
+{
+   Guard guard(this);
+   Node * pNode = findPreds(k, nullptr);
+   if (pNode && !compare(k, pNode->data.first))
+      return pNode->data.second;
+   throw std::out_of_range("invalid skiplist_map<K, T> key");
+}
+
+/************************************************
+ * SKIPLIST MAP :: INSERT
+ ***********************************************/
+template <class K, class V, class Compare>
+custom::pair <typename skiplist_map <K, V, Compare> :: iterator, bool>
+skiplist_map <K, V, Compare> :: insert(const Pairs & rhs)
+{
+   Guard guard(this);
+   std::lock_guard <std::mutex> lock(writer);
+
+   Node * preds[maxLevel];
+   Node * pNext = findPreds(rhs.first, preds);
+   if (pNext && !compare(rhs.first, pNext->data.first))
+      return custom::pair <iterator, bool> (iterator(guard, pNext), false);
+
+   return custom::pair <iterator, bool> (iterator(guard, link(rhs.first, rhs.second, preds)), true);
+}
+
+/************************************************
+ * SKIPLIST MAP :: INSERT OR ASSIGN
+ * A new key goes in as with insert. For a key that
+ * is here, a copy of its node with the new value
+ * takes the old one's place at every level. A reader
+ * may pass through either, and both lead on to the
+ * same nodes.
+ ***********************************************/
+template <class K, class V, class Compare>
+custom::pair <typename skiplist_map <K, V, Compare> :: iterator, bool>
+skiplist_map <K, V, Compare> :: insert_or_assign(const K & k, const V & v)
+{
+   Guard guard(this);
+   std::lock_guard <std::mutex> lock(writer);
+
+   Node * preds[maxLevel];
+   Node * pOld = findPreds(k, preds);
+   if (pOld == nullptr || compare(k, pOld->data.first))
+      return custom::pair <iterator, bool> (iterator(guard, link(k, v, preds)), true);
+
+   Node * pNode = allocate(k, v, pOld->height);
+   for (int i = 0; i < pOld->height; i++)
+      pNode->next[i].store(pOld->next[i].load(std::memory_order_relaxed),
+                           std::memory_order_relaxed);
+   for (int i = 0; i < pOld->height; i++)
+      linksOf(preds[i])[i].store(pNode, std::memory_order_release);
+   retire(pOld);
+   return custom::pair <iterator, bool> (iterator(guard, pNode), false);
+}
+
+/************************************************
+ * SKIPLIST MAP :: ERASE
+ * Unlink from the top down, so that by the time
+ * the bottom link goes no new search can land on
+ * the node, then retire it.
+ ***********************************************/
+template <class K, class V, class Compare>
+size_t skiplist_map <K, V, Compare> :: erase(const K & k)
+{
+   std::lock_guard <std::mutex> lock(writer);
+
+   Node * preds[maxLevel];
+   Node * pNode = findPreds(k, preds);
+   if (pNode == nullptr || compare(k, pNode->data.first))
+      return 0;
+
+   for (int i = pNode->height - 1; i >= 0; i--)
+      linksOf(preds[i])[i].store(pNode->next[i].load(std::memory_order_relaxed),
+                                 std::memory_order_release);
+   numElements.fetch_sub(1, std::memory_order_relaxed);
+   retire(pNode);
+   return 1;
+}
+
+/************************************************
+ * SKIPLIST MAP :: CLEAR
+ * Cut every node loose at once, then retire them
+ ***********************************************/
+template <class K, class V, class Compare>
+void skiplist_map <K, V, Compare> :: clear()
+{
+   std::lock_guard <std::mutex> lock(writer);
+
+   Node * pNode = head[0].load(std::memory_order_relaxed);
+   for (int i = maxLevel - 1; i >= 0; i--)
+      head[i].store(nullptr, std::memory_order_release);
+   numElements.store(0, std::memory_order_relaxed);
+
+   while (pNode)
+   {
+      Node * pNext = pNode->next[0].load(std::memory_order_relaxed);
+      retired.push_back(Retired{ pNode, epoch.load() });
+      pNode = pNext;
+   }
+   epoch.fetch_add(1);
+   reclaim();
+}
+
+/************************************************
+ * SKIPLIST MAP :: FIND PREDS
+ * The first node not less than k, or null. If preds
+ * is given, also the last node before k at each
+ * level, with null meaning the head.
+ ***********************************************/
+template <class K, class V, class Compare>
+typename skiplist_map <K, V, Compare> :: Node *
+skiplist_map <K, V, Compare> :: findPreds(const K & k, Node * preds[maxLevel]) const
+{
+   Node * pPred = nullptr;
+   Node * pNext = nullptr;
+   for (int i = maxLevel - 1; i >= 0; i--)
+   {
+      pNext = linksOf(pPred)[i].load(std::memory_order_acquire);
+      while (pNext && compare(pNext->data.first, k))
+      {
+         pPred = pNext;
+         pNext = pNext->next[i].load(std::memory_order_acquire);
+      }
+      if (preds)
+         preds[i] = pPred;
+   }
+   return pNext;
+}
+
+/************************************************
+ * SKIPLIST MAP :: LINK
+ * Build the node, then link it in from the bottom
+ * up after preds. Once the bottom link is stored the
+ * pair is in the map; the upper links only speed up
+ * search. The writer lock must be held.
+ ***********************************************/
+template <class K, class V, class Compare>
+typename skiplist_map <K, V, Compare> :: Node *
+skiplist_map <K, V, Compare> :: link(const K & k, const V & v, Node * preds[maxLevel])
+{
+   int height = randomHeight();
+   Node * pNode = allocate(k, v, height);
+   for (int i = 0; i < height; i++)
+      pNode->next[i].store(linksOf(preds[i])[i].load(std::memory_order_relaxed),
+                           std::memory_order_relaxed);
+   for (int i = 0; i < height; i++)
+      linksOf(preds[i])[i].store(pNode, std::memory_order_release);
+   numElements.fetch_add(1, std::memory_order_relaxed);
+   return pNode;
+}
+
+/************************************************
+ * SKIPLIST MAP :: RANDOM HEIGHT
+ * Each level up with probability 1/4: two random
+ * bits at a time must both be 0
+ ***********************************************/
+template <class K, class V, class Compare>
+int skiplist_map <K, V, Compare> :: randomHeight()
+{
+   seed ^= seed << 13;
+   seed ^= seed >> 7;
+   seed ^= seed << 17;
+   uint64_t bits = seed;
+   int height = 1;
+   while (height < maxLevel && (bits & 3) == 0)
+   {
+      height++;
+      bits >>= 2;
+   }
+   return height;
+}
+
+/************************************************
+ * SKIPLIST MAP :: RETIRE
+ * Tag an unlinked node with the epoch now, start a
+ * new epoch, and free whatever is safe to free. The
+ * fence keeps the unlink ahead of the slot scan.
+ ***********************************************/
+template <class K, class V, class Compare>
+void skiplist_map <K, V, Compare> :: retire(Node * pNode)
+{
+   retired.push_back(Retired{ pNode, epoch.load() });
+   epoch.fetch_add(1);
+   reclaim();
+}
+
+/************************************************
+ * SKIPLIST MAP :: RECLAIM
+ * A reader that started in epoch e may hold nodes
+ * retired in e or later, but not ones retired
+ * before. Free everything retired before the
+ * oldest epoch any slot is in.
+ ***********************************************/
+template <class K, class V, class Compare>
+void skiplist_map <K, V, Compare> :: reclaim()
+{
+   std::atomic_thread_fence(std::memory_order_seq_cst);
+   uint64_t oldest = epoch.load();
+   for (size_t i = 0; i < numSlots; i++)
+   {
+      uint64_t state = slots[i].state.load();
+      if (state != 0 && (state >> countBits) < oldest)
+         oldest = state >> countBits;
+   }
+
+   size_t numKeep = 0;
+   for (size_t i = 0; i < retired.size(); i++)
+      if (retired[i].epoch < oldest)
+         deallocate(retired[i].pNode);
+      else
+         retired[numKeep++] = retired[i];
+   while (retired.size() > numKeep)
+      retired.pop_back();
+}
+
+/************************************************
+ * SKIPLIST MAP :: ALLOCATE
+ * One block for the node and its whole tower
+ ***********************************************/
+template <class K, class V, class Compare>
+typename skiplist_map <K, V, Compare> :: Node *
+skiplist_map <K, V, Compare> :: allocate(const K & k, const V & v, int height)
+{
+   void * p = ::operator new(sizeof(Node) + (height - 1) * sizeof(std::atomic <Node *>));
+   Node * pNode = new (p) Node(k, v, height);
+   for (int i = 1; i < height; i++)
+      new ((void *)(pNode->next + i)) std::atomic <Node *> (nullptr);
+   return pNode;
+}
+
+/************************************************
+ * SKIPLIST MAP :: DEALLOCATE
+ ***********************************************/
+template <class K, class V, class Compare>
+void skiplist_map <K, V, Compare> :: deallocate(Node * pNode)
+{
+   pNode->~Node();
+   ::operator delete((void *)pNode);
+}
+
+};
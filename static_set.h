@@ -0,0 +1,345 @@
+/***********************************************************************
+ * Header:
+ *    STATIC SET
+ * Summary:
+ *    A read-only set laid out for fast searching
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        static_set            : A frozen set in Eytzinger order
+ *        static_set::iterator  : An in-order iterator through a static_set
+ *        freeze                : Make a static_set from a set
+ * Author
+ *    Tyler and Braeden
+ ************************************************************************/
+
+#pragma once
+
+#include "set.h"       // for freeze
+#include "vector.h"    // the elements live in a vector
+#include <algorithm>   // for std::sort and std::is_sorted
+#include <cstdint>     // for uint64_t and uintptr_t
+#include <functional>  // for std::less
+
+class TestStaticSet;    // forward declaration for unit tests
+
+namespace custom
+{
+
+/************************************************
+ * STATIC SET
+ * A set that never changes once built, stored as one
+ * array in Eytzinger (breadth-first) order: the root
+ * at 1, and the children of k at 2k and 2k+1. A search
+ * walks down by doubling the index and adding one bit,
+ * the comparison result, so there is no branch to
+ * mispredict. The top levels share a few cache lines,
+ * and the descendants four or so levels below k are
+ * next to each other, so each step prefetches them
+ * while it works on the current level.
+ *
+ * Slot k is stored at elements[k - 1].
+ ************************************************/
+template <typename T, typename Compare = std::less<T>>
+class static_set
+{
+   friend class ::TestStaticSet;   // give unit tests access to the privates
+public:
+
+   //
+   // Construct
+   //
+   static_set()
+   {
+   }
+   template <class Iterator>
+   static_set(Iterator first, Iterator last);
+   static_set(const std::initializer_list <T>& il) : static_set(il.begin(), il.end())
+   {
+   }
+
+   //
+   // Iterator
+   //
+   class iterator;
+   iterator begin() const;
+   iterator end() const
+   {
+      return iterator(this, 0);
+   }
+
+   //
+   // Access
+   //
+   iterator find(const T& t) const
+   {
+      size_t k = lowerBound(t);
+      return iterator(this, (k != 0 && !comp(t, elements[k - 1])) ? k : 0);
+   }
+   iterator lower_bound(const T& t) const
+   {
+      return iterator(this, lowerBound(t));
+   }
+   size_t count(const T& t) const
+   {
+      return find(t) == end() ? 0 : 1;
+   }
+   bool contains(const T& t) const
+   {
+      return find(t) != end();
+   }
+
+   //
+   // Status
+   //
+   bool empty() const noexcept
+   {
+      return elements.empty();
+   }
+   size_t size() const noexcept
+   {
+      return elements.size();
+   }
+
+private:
+   // How many elements fit in a cache line: the block of
+   // descendants four levels down when T is a 4-byte int
+   static constexpr size_t prefetchStride = sizeof(T) >= 64 ? 1 : 64 / sizeof(T);
+
+   size_t lowerBound(const T& t) const;
+   size_t layout(const custom::vector<T>& sorted, custom::vector<size_t>& slots,
+                 size_t iSorted, size_t k) const;
+
+   static unsigned trailingZeros(uint64_t x);
+   static void prefetch(const T* p, size_t index)
+   {
+#if defined(__GNUC__) || defined(__clang__)
+      // The hint never faults, so it may run past the end
+      __builtin_prefetch((const void*)((uintptr_t)p + index * sizeof(T)));
+#endif
+   }
+
+   custom::vector<T> elements;   // slot k at k - 1, Eytzinger order
+   Compare comp;                 // the ordering
+};
+
+/**************************************************
+ * STATIC SET ITERATOR
+ * Walks the Eytzinger array in sorted order. The
+ * next slot is the leftmost in the right subtree,
+ * or else up past every ancestor we are the right
+ * child of. Slot 0 is the end.
+ *************************************************/
+template <typename T, typename Compare>
+class static_set <T, Compare> :: iterator
+{
+   friend class ::TestStaticSet;   // give unit tests access to the privates
+   friend class static_set;
+public:
+   // constructors, destructors, and assignment operator
+   iterator() : pSet(nullptr), k(0)
+   {
+   }
+   iterator(const static_set* pSet, size_t k) : pSet(pSet), k(k)
+   {
+   }
+   iterator(const iterator& rhs) : pSet(rhs.pSet), k(rhs.k)
+   {
+   }
+   iterator& operator = (const iterator& rhs)
+   {
+      pSet = rhs.pSet;
+      k = rhs.k;
+      return *this;
+   }
+
+   // equals, not equals operator
+   bool operator != (const iterator& rhs) const { return k != rhs.k; }
+   bool operator == (const iterator& rhs) const { return k == rhs.k; }
+
+   // dereference operator
+   const T& operator * () const
+   {
+      return pSet->elements[k - 1];
+   }
+
+   // increment and decrement
+   iterator& operator ++ ()
+   {
+      size_t n = pSet->size();
+      if (2 * k + 1 <= n)
+      {
+         k = 2 * k + 1;
+         while (2 * k <= n)
+            k = 2 * k;
+      }
+      else
+         k >>= trailingZeros(~(uint64_t)k) + 1;
+      return *this;
+   }
+   iterator operator ++ (int postfix)
+   {
+      iterator old(*this);
+      ++*this;
+      return old;
+   }
+   iterator& operator -- ()
+   {
+      size_t n = pSet->size();
+      if (k == 0)
+      {
+         // from the end back to the largest
+         k = n ? 1 : 0;
+         while (k && 2 * k + 1 <= n)
+            k = 2 * k + 1;
+      }
+      else if (2 * k <= n)
+      {
+         k = 2 * k;
+         while (2 * k + 1 <= n)
+            k = 2 * k + 1;
+      }
+      else
+         k >>= trailingZeros(k) + 1;
+      return *this;
+   }
+   iterator operator -- (int postfix)
+   {
+      iterator old(*this);
+      --*this;
+      return old;
+   }
+
+private:
+   const static_set* pSet;
+   size_t k;                  // the slot, 1-based, or 0 for the end
+};
+
+/*****************************************
+ * STATIC SET :: CONSTRUCTOR
+ * Gather the range, sort it and drop repeats if it
+ * did not come from a set already, then place each
+ * element at its Eytzinger slot
+ ****************************************/
+template <typename T, typename Compare>
+template <class Iterator>
+static_set<T, Compare>::static_set(Iterator first, Iterator last)
+{
+   custom::vector<T> sorted;
+   for (; first != last; ++first)
+      sorted.push_back(*first);
+   if (sorted.empty())
+      return;
+
+   T* p = &sorted[0];
+   size_t n = sorted.size();
+   if (!std::is_sorted(p, p + n, comp))
+      std::sort(p, p + n, comp);
+   size_t numKeep = 1;
+   for (size_t i = 1; i < n; i++)
+      if (comp(p[numKeep - 1], p[i]))
+      {
+         if (i != numKeep)
+            p[numKeep] = std::move(p[i]);
+         numKeep++;
+      }
+   while (sorted.size() > numKeep)
+      sorted.pop_back();
+
+   // slots[k - 1] is the index in sorted of the element for slot k
+   custom::vector<size_t> slots(sorted.size());
+   elements.reserve(sorted.size());
+   layout(sorted, slots, 0, 1);
+   for (size_t k = 1; k <= sorted.size(); k++)
+      elements.push_back(std::move(sorted[slots[k - 1]]));
+}
+
+/*****************************************
+ * STATIC SET :: LAYOUT
+ * An in-order walk of the implicit tree hands out
+ * the sorted elements in turn. Returns the next
+ * unused index into sorted.
+ ****************************************/
+template <typename T, typename Compare>
+size_t static_set<T, Compare>::layout(const custom::vector<T>& sorted,
+                                      custom::vector<size_t>& slots,
+                                      size_t iSorted, size_t k) const
+{
+   if (k > sorted.size())
+      return iSorted;
+   iSorted = layout(sorted, slots, iSorted, 2 * k);
+   slots[k - 1] = iSorted++;
+   return layout(sorted, slots, iSorted, 2 * k + 1);
+}
+
+/*****************************************
+ * STATIC SET :: BEGIN
+ * The leftmost slot
+ ****************************************/
+template <typename T, typename Compare>
+typename static_set<T, Compare>::iterator static_set<T, Compare>::begin() const
+{
+   size_t k = empty() ? 0 : 1;
+   while (k && 2 * k <= size())
+      k = 2 * k;
+   return iterator(this, k);
+}
+
+/*****************************************
+ * STATIC SET :: LOWER BOUND
+ * Go right (add 1) when the slot is less than t.
+ * Past the bottom, k's bits are the path taken;
+ * the answer is the last node where we went left,
+ * found by dropping the trailing right turns and
+ * that left turn. All right turns leaves 0, the end.
+ ****************************************/
+template <typename T, typename Compare>
+size_t static_set<T, Compare>::lowerBound(const T& t) const
+{
+   size_t n = elements.size();
+   if (n == 0)
+      return 0;
+   const T* p = &elements[0];
+   size_t k = 1;
+   while (k <= n)
+   {
+      prefetch(p, k * prefetchStride - 1);
+      k = 2 * k + comp(p[k - 1], t);
+   }
+   return k >> (trailingZeros(~(uint64_t)k) + 1);
+}
+
+/************************************************
+ * STATIC SET :: TRAILING ZEROS
+ * The number of 0 bits below the lowest 1; x is not 0
+ ***********************************************/
+template <typename T, typename Compare>
+unsigned static_set<T, Compare>::trailingZeros(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+   return (unsigned)__builtin_ctzll(x);
+#else
+   unsigned bits = 0;
+   for (; (x & 1) == 0; x >>= 1)
+      bits++;
+   return bits;
+#endif
+}
+
+/*****************************************
+ * FREEZE
+ * A static_set holding everything in a set. The
+ * set comes out in order, so no sorting is needed.
+ ****************************************/
+template <typename T>
+static_set<T> freeze(const set<T>& s)
+{
+   return static_set<T>(s.begin(), s.end());
+}
+
+}
@@ -0,0 +1,271 @@
+/***********************************************************************
+ * Header:
+ *    UNORDERED MAP
+ * Summary:
+ *    Our custom implementation of std::unordered_map
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *    This will contain the class definition of:
+ *        unordered_map           : A hash of key/value pairs
+ * Author
+ *    Tyler and Braeden
+ ************************************************************************/
+
+#pragma once
+
+#include "pair.h"     // for pair
+#include "hash.h"     // the buckets, rehash and iterators come from unordered_set
+#include <functional> // for std::hash and std::equal_to
+#include <memory>     // for std::allocator
+#include <stdexcept>  // for std::out_of_range
+
+class TestUnorderedMap;     // forward declaration for unit tests
+
+namespace custom
+{
+
+/************************************************
+ * UNORDERED MAP
+ * An unordered_set of pairs that hashes and compares
+ * only the key. Lookups go straight to the set's
+ * buckets with the bare key, so finding never builds
+ * a pair or a V.
+ ************************************************/
+template <typename K,
+          typename V,
+          typename Hash = std::hash<K>,
+          typename EqPred = std::equal_to<K>,
+          typename A = std::allocator<custom::pair<K, V>> >
+class unordered_map
+{
+   friend class ::TestUnorderedMap;   // give unit tests access to the privates
+public:
+   using Pairs = custom::pair<K, V>;
+
+private:
+   // Hash and compare a pair by its key, or a bare key against a pair
+   struct KeyHash
+   {
+      size_t operator()(const Pairs& p) const { return Hash()(p.first); }
+      size_t operator()(const K& k)     const { return Hash()(k);       }
+   };
+   struct KeyEq
+   {
+      bool operator()(const Pairs& lhs, const Pairs& rhs) const { return EqPred()(lhs.first, rhs.first); }
+      bool operator()(const Pairs& lhs, const K& k)       const { return EqPred()(lhs.first, k);         }
+   };
+   using Table = unordered_set<Pairs, KeyHash, KeyEq, A>;
+
+public:
+   using iterator = typename Table::iterator;
+
+   //
+   // Construct
+   //
+   unordered_map()
+   {
+   }
+   unordered_map(size_t numBuckets) : table(numBuckets)
+   {
+   }
+   unordered_map(const unordered_map& rhs) : table(rhs.table)
+   {
+   }
+   unordered_map(unordered_map&& rhs) : table(std::move(rhs.table))
+   {
+   }
+   template <class Iterator>
+   unordered_map(Iterator first, Iterator last)
+   {
+      for (; first != last; ++first)
+         insert(*first);
+   }
+   unordered_map(const std::initializer_list<Pairs>& il)
+   {
+      insert(il);
+   }
+
+   //
+   // Assign
+   //
+   unordered_map& operator = (const unordered_map& rhs)
+   {
+      table = rhs.table;
+      return *this;
+   }
+   unordered_map& operator = (unordered_map&& rhs)
+   {
+      table = std::move(rhs.table);
+      return *this;
+   }
+   void swap(unordered_map& rhs)
+   {
+      table.swap(rhs.table);
+   }
+
+   //
+   // Iterator
+   //
+   iterator begin() { return table.begin(); }
+   iterator end()   { return table.end();   }
+
+   //
+   // Access
+   //
+   V& operator [] (const K& k);
+   V& operator [] (K&& k);
+   V& at(const K& k);
+   iterator find(const K& k)
+   {
+      return table.findKey(k);
+   }
+   size_t count(const K& k)
+   {
+      return find(k) == end() ? 0 : 1;
+   }
+
+   //
+   // Insert
+   //
+   custom::pair<iterator, bool> insert(const Pairs& rhs)
+   {
+      return table.insert(rhs);
+   }
+   custom::pair<iterator, bool> insert(Pairs&& rhs)
+   {
+      return table.insert(std::move(rhs));
+   }
+   void insert(const std::initializer_list<Pairs>& il)
+   {
+      for (auto& rhs : il)
+         insert(rhs);
+   }
+   template <class... Args>
+   custom::pair<iterator, bool> try_emplace(const K& k, Args&&... args);
+   template <class M>
+   custom::pair<iterator, bool> insert_or_assign(const K& k, M&& m);
+   void reserve(size_t num)        { table.reserve(num);        }
+   void rehash(size_t numBuckets)  { table.rehash(numBuckets);  }
+
+   //
+   // Remove
+   //
+   void clear() noexcept
+   {
+      table.clear();
+   }
+   size_t erase(const K& k)
+   {
+      iterator it = find(k);
+      if (it == end())
+         return 0;
+      table.erase(it);
+      return 1;
+   }
+   iterator erase(const iterator& it)
+   {
+      return table.erase(it);
+   }
+
+   //
+   // Status
+   //
+   size_t size() const              { return table.size();            }
+   bool empty() const               { return table.empty();           }
+   size_t bucket_count() const      { return table.bucket_count();    }
+   float max_load_factor() const    { return table.max_load_factor(); }
+   void  max_load_factor(float m)   { table.max_load_factor(m);       }
+
+private:
+   Table table;   // the pairs, hashed on their keys
+};
+
+/*****************************************
+ * UNORDERED MAP :: SQUARE BRACKET
+ * Find the value for a key, adding a default one
+ * if the key is new
+ ****************************************/
+template <typename K, typename V, typename H, typename E, typename A>
+V& unordered_map<K, V, H, E, A>::operator [] (const K& k)
+{
+   iterator it = find(k);
+   if (it == end())
+      it = table.insertNew(Pairs(k));
+   return (*it).second;
+}
+template <typename K, typename V, typename H, typename E, typename A>
+V& unordered_map<K, V, H, E, A>::operator [] (K&& k)
+{
+   iterator it = find(k);
+   if (it == end())
+      it = table.insertNew(Pairs(std::move(k), V()));
+   return (*it).second;
+}
+
+/*****************************************
+ * UNORDERED MAP :: AT
+ * Find the value for a key that must be here
+ ****************************************/
+template <typename K, typename V, typename H, typename E, typename A>
+V& unordered_map<K, V, H, E, A>::at(const K& k)
+{
+   iterator it = find(k);
+   if (it == end())
+      throw std::out_of_range("invalid unordered_map<K, T> key");
+   return (*it).second;
+}
+
+/*****************************************
+ * UNORDERED MAP :: TRY EMPLACE
+ * Add a key with a value built from args, but only if
+ * the key is new. An existing value is left alone and
+ * args are not touched.
+ ****************************************/
+template <typename K, typename V, typename H, typename E, typename A>
+template <class... Args>
+custom::pair<typename unordered_map<K, V, H, E, A>::iterator, bool>
+unordered_map<K, V, H, E, A>::try_emplace(const K& k, Args&&... args)
+{
+   iterator it = find(k);
+   if (it != end())
+      return custom::pair<iterator, bool>(it, false);
+   it = table.insertNew(Pairs(k, V(std::forward<Args>(args)...)));
+   return custom::pair<iterator, bool>(it, true);
+}
+
+/*****************************************
+ * UNORDERED MAP :: INSERT OR ASSIGN
+ * Add a key with value m, or give an existing key
+ * value m. The bool says whether the key was new.
+ ****************************************/
+template <typename K, typename V, typename H, typename E, typename A>
+template <class M>
+custom::pair<typename unordered_map<K, V, H, E, A>::iterator, bool>
+unordered_map<K, V, H, E, A>::insert_or_assign(const K& k, M&& m)
+{
+   iterator it = find(k);
+   if (it != end())
+   {
+      (*it).second = std::forward<M>(m);
+      return custom::pair<iterator, bool>(it, false);
+   }
+   it = table.insertNew(Pairs(k, V(std::forward<M>(m))));
+   return custom::pair<iterator, bool>(it, true);
+}
+
+/*****************************************
+ * SWAP
+ * Stand-alone unordered map swap
+ ****************************************/
+template <typename K, typename V, typename H, typename E, typename A>
+void swap(unordered_map<K, V, H, E, A>& lhs, unordered_map<K, V, H, E, A>& rhs)
+{
+   lhs.swap(rhs);
+}
+
+}
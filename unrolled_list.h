@@ -0,0 +1,578 @@
+/***********************************************************************
+ * Header:
+ *    UNROLLED LIST
+ * Summary:
+ *    A linked list that stores a small array of elements in each node
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *
+ *    This will contain the class definition of:
+ *        unrolled_list            : A list of small arrays
+ *        unrolled_list::iterator  : An iterator through the list
+ * Author
+ *    Tyler and Braedon
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <initializer_list>
+#include <memory>      // for std::allocator
+#include <new>         // std::bad_alloc
+
+class TestUnrolledList;    // forward declaration for unit tests
+
+namespace custom
+{
+
+/**************************************************
+ * UNROLLED LIST
+ * The same interface as list, but each node holds up
+ * to K elements side by side. Walking the list touches
+ * one node per K elements, and the two pointers are
+ * paid for once per K elements rather than per element.
+ * A full node splits in half to make room. A node
+ * that erase leaves less than half full takes one
+ * element from a neighbour with more than half, or
+ * else merges with it, so nodes stay at least half
+ * full and the list does not fill up with slivers.
+ **************************************************/
+template <typename T,
+          size_t K = (256 / sizeof(T) > 4 ? 256 / sizeof(T) : 4),
+          typename A = std::allocator<T>>
+class unrolled_list
+{
+   static_assert(K >= 2, "an unrolled list node needs room for at least two elements");
+
+   friend class ::TestUnrolledList; // give unit tests access to the privates
+
+   class Node;
+   using NodeAlloc  = typename std::allocator_traits<A>::template rebind_alloc<Node>;
+   using NodeTraits = std::allocator_traits<NodeAlloc>;
+   using Traits     = std::allocator_traits<A>;
+
+public:
+
+   //
+   // Construct
+   //
+
+   unrolled_list(const A & a = A()) :
+      alloc(a), nodeAlloc(a), numElements(0), pHead(nullptr), pTail(nullptr)
+   {
+   }
+   unrolled_list(const unrolled_list & rhs) : unrolled_list(rhs.alloc)
+   {
+      *this = rhs;
+   }
+   unrolled_list(unrolled_list && rhs) : unrolled_list(rhs.alloc)
+   {
+      swap(rhs);
+   }
+   unrolled_list(const std::initializer_list<T> & il, const A & a = A()) : unrolled_list(a)
+   {
+      *this = il;
+   }
+   template <class Iterator>
+   unrolled_list(Iterator first, Iterator last, const A & a = A()) : unrolled_list(a)
+   {
+      while (first != last)
+         push_back(*(first++));
+   }
+   ~unrolled_list()
+   {
+      clear();
+   }
+
+   //
+   // Assign
+   //
+
+   unrolled_list & operator = (const unrolled_list & rhs);
+   unrolled_list & operator = (unrolled_list && rhs)
+   {
+      clear();
+      swap(rhs);
+      return *this;
+   }
+   unrolled_list & operator = (const std::initializer_list<T> & il)
+   {
+      clear();
+      for (const T & t : il)
+         push_back(t);
+      return *this;
+   }
+   void swap(unrolled_list & rhs)
+   {
+      std::swap(numElements, rhs.numElements);
+      std::swap(pHead, rhs.pHead);
+      std::swap(pTail, rhs.pTail);
+   }
+
+   //
+   // Iterator
+   //
+
+   class iterator;
+   iterator begin()  { return iterator(pHead, 0); }
+   iterator rbegin() { return pTail ? iterator(pTail, pTail->count - 1) : end(); }
+   iterator end()    { return iterator(nullptr, 0); }
+
+   //
+   // Access
+   //
+
+   T & front();
+   T & back();
+
+   //
+   // Insert
+   //
+
+   void push_front(const T &  data) { push_front(T(data)); }
+   void push_front(      T && data);
+   void push_back (const T &  data);
+   void push_back (      T && data);
+   iterator insert(iterator it, const T &  data) { return insert(it, T(data)); }
+   iterator insert(iterator it,       T && data);
+
+   //
+   // Remove
+   //
+
+   void pop_back()  { if (pTail) erase(rbegin()); }
+   void pop_front() { if (pHead) erase(begin());  }
+   void clear();
+   iterator erase(const iterator & it);
+
+   //
+   // Status
+   //
+
+   bool empty()  const { return numElements == 0; }
+   size_t size() const { return numElements;      }
+
+private:
+
+   Node * newNodeAfter(Node * pPrev);
+   void   deleteNode(Node * p);
+   void   mergeNext(Node * p);
+   void   relocate(T * pDest, T * pSrc);
+   template <class U>
+   void   insertAt(Node * p, size_t i, U && u);
+
+   A         alloc;        // builds and destroys the elements
+   NodeAlloc nodeAlloc;    // allocates the nodes
+   size_t numElements;     // elements across all the nodes
+   Node * pHead;           // pointer to the first node
+   Node * pTail;           // pointer to the last node
+};
+
+/*************************************************
+ * UNROLLED LIST NODE
+ * Room for K elements, the first count of which
+ * are alive. The elements are built in place as
+ * needed, so T needs no default constructor.
+ *************************************************/
+template <typename T, size_t K, typename A>
+class unrolled_list <T, K, A> :: Node
+{
+public:
+   Node() : count(0), pNext(nullptr), pPrev(nullptr)
+   {
+   }
+
+   T * slot(size_t i)
+   {
+      return reinterpret_cast<T *>(buffer) + i;
+   }
+
+   alignas(T) unsigned char buffer[K * sizeof(T)];   // the elements
+   size_t count;       // how many of the K slots are in use
+   Node * pNext;       // pointer to next node
+   Node * pPrev;       // pointer to previous node
+};
+
+/*************************************************
+ * UNROLLED LIST ITERATOR
+ * A node and a slot within it
+ ************************************************/
+template <typename T, size_t K, typename A>
+class unrolled_list <T, K, A> :: iterator
+{
+   friend class ::TestUnrolledList; // give unit tests access to the privates
+   template <typename TT, size_t KK, typename AA>
+   friend class custom::unrolled_list;
+
+public:
+   // constructors, destructors, and assignment operator
+   iterator() : p(nullptr), i(0)
+   {
+   }
+
+   // equals, not equals operator
+   bool operator == (const iterator & rhs) const { return p == rhs.p && i == rhs.i; }
+   bool operator != (const iterator & rhs) const { return !(*this == rhs);         }
+
+   // dereference operator
+   T & operator * ()
+   {
+      return *p->slot(i);
+   }
+
+   // prefix increment
+   iterator & operator ++ ()
+   {
+      if (++i == p->count)
+      {
+         p = p->pNext;
+         i = 0;
+      }
+      return *this;
+   }
+
+   // postfix increment
+   iterator operator ++ (int postfix)
+   {
+      iterator temp(*this);
+      ++(*this);
+      return temp;
+   }
+
+   // prefix decrement
+   iterator & operator -- ()
+   {
+      if (i == 0)
+      {
+         p = p->pPrev;
+         i = p ? p->count - 1 : 0;
+      }
+      else
+         --i;
+      return *this;
+   }
+
+   // postfix decrement
+   iterator operator -- (int postfix)
+   {
+      iterator temp(*this);
+      --(*this);
+      return temp;
+   }
+
+private:
+   iterator(Node * p, size_t i) : p(p), i(i)
+   {
+   }
+
+   Node * p;      // the node, or nullptr for end()
+   size_t i;      // the slot within the node
+};
+
+/**********************************************
+ * UNROLLED LIST :: ASSIGNMENT OPERATOR
+ * Copy one list onto another
+ **********************************************/
+template <typename T, size_t K, typename A>
+unrolled_list <T, K, A> & unrolled_list <T, K, A> :: operator = (const unrolled_list & rhs)
+{
+   if (this == &rhs)
+      return *this;
+   clear();
+   for (Node * p = rhs.pHead; p; p = p->pNext)
+      for (size_t i = 0; i < p->count; i++)
+         push_back(*p->slot(i));
+   return *this;
+}
+
+/*********************************************
+ * UNROLLED LIST :: FRONT / BACK
+ *********************************************/
+template <typename T, size_t K, typename A>
+T & unrolled_list <T, K, A> :: front()
+{
+   if (empty())
+      throw "ERROR: unable to access data from an empty list";
+   return *pHead->slot(0);
+}
+template <typename T, size_t K, typename A>
+T & unrolled_list <T, K, A> :: back()
+{
+   if (empty())
+      throw "ERROR: unable to access data from an empty list";
+   return *pTail->slot(pTail->count - 1);
+}
+
+/*********************************************
+ * UNROLLED LIST :: PUSH BACK
+ * Add to the last node, or start a new one
+ *    COST : O(1)
+ *********************************************/
+template <typename T, size_t K, typename A>
+void unrolled_list <T, K, A> :: push_back(const T & data)
+{
+   if (pTail == nullptr || pTail->count == K)
+      newNodeAfter(pTail);
+   Traits::construct(alloc, pTail->slot(pTail->count), data);
+   pTail->count++;
+   numElements++;
+}
+template <typename T, size_t K, typename A>
+void unrolled_list <T, K, A> :: push_back(T && data)
+{
+   if (pTail == nullptr || pTail->count == K)
+      newNodeAfter(pTail);
+   Traits::construct(alloc, pTail->slot(pTail->count), std::move(data));
+   pTail->count++;
+   numElements++;
+}
+
+/*********************************************
+ * UNROLLED LIST :: PUSH FRONT
+ * Add to the first node, or start a new one
+ *    COST : O(K)
+ *********************************************/
+template <typename T, size_t K, typename A>
+void unrolled_list <T, K, A> :: push_front(T && data)
+{
+   if (pHead == nullptr || pHead->count == K)
+      newNodeAfter(nullptr);
+   insertAt(pHead, 0, std::move(data));
+}
+
+/******************************************
+ * UNROLLED LIST :: INSERT
+ * Add an element before the iterator. A full
+ * node is split in half first.
+ *    COST : O(K)
+ ******************************************/
+template <typename T, size_t K, typename A>
+typename unrolled_list <T, K, A> :: iterator
+unrolled_list <T, K, A> :: insert(iterator it, T && data)
+{
+   if (it.p == nullptr)
+   {
+      push_back(std::move(data));
+      return rbegin();
+   }
+
+   Node * p = it.p;
+   size_t i = it.i;
+   if (p->count == K)
+   {
+      // Move the upper half into a new node after this one
+      Node * pNew = newNodeAfter(p);
+      size_t half = K / 2;
+      for (size_t j = half; j < K; j++)
+         relocate(pNew->slot(j - half), p->slot(j));
+      pNew->count = K - half;
+      p->count = half;
+
+      if (i > half)
+      {
+         p = pNew;
+         i -= half;
+      }
+   }
+
+   insertAt(p, i, std::move(data));
+   return iterator(p, i);
+}
+
+/******************************************
+ * UNROLLED LIST :: ERASE
+ * Remove the element at the iterator, returning
+ * the next one. An empty node is freed; one
+ * less than half full borrows from or merges
+ * with a neighbour, the next one if it has one.
+ *    COST : O(K)
+ ******************************************/
+template <typename T, size_t K, typename A>
+typename unrolled_list <T, K, A> :: iterator
+unrolled_list <T, K, A> :: erase(const iterator & it)
+{
+   Node * p = it.p;
+   size_t i = it.i;
+   assert(p != nullptr && i < p->count);
+
+   Traits::destroy(alloc, p->slot(i));
+   for (size_t j = i + 1; j < p->count; j++)
+      relocate(p->slot(j - 1), p->slot(j));
+   p->count--;
+   numElements--;
+
+   if (p->count == 0)
+   {
+      Node * pNext = p->pNext;
+      deleteNode(p);
+      return iterator(pNext, 0);
+   }
+
+   const size_t half = K / 2;
+   Node * pNext = p->pNext;
+   Node * pPrev = p->pPrev;
+   if (p->count < half && pNext != nullptr)
+   {
+      if (pNext->count > half)
+      {
+         // Take the first element of the next node
+         relocate(p->slot(p->count), pNext->slot(0));
+         for (size_t j = 1; j < pNext->count; j++)
+            relocate(pNext->slot(j - 1), pNext->slot(j));
+         p->count++;
+         pNext->count--;
+      }
+      else
+         mergeNext(p);
+   }
+   else if (p->count < half && pPrev != nullptr)
+   {
+      if (pPrev->count > half)
+      {
+         // Take the last element of the previous node
+         for (size_t j = p->count; j > 0; j--)
+            relocate(p->slot(j), p->slot(j - 1));
+         relocate(p->slot(0), pPrev->slot(pPrev->count - 1));
+         pPrev->count--;
+         p->count++;
+         i++;
+      }
+      else
+      {
+         i += pPrev->count;
+         mergeNext(pPrev);
+         p = pPrev;
+      }
+   }
+
+   if (i < p->count)
+      return iterator(p, i);
+   return iterator(p->pNext, 0);
+}
+
+/**********************************************
+ * UNROLLED LIST :: CLEAR
+ * Remove all the items currently in the list
+ **********************************************/
+template <typename T, size_t K, typename A>
+void unrolled_list <T, K, A> :: clear()
+{
+   while (pHead != nullptr)
+   {
+      Node * p = pHead;
+      for (size_t i = 0; i < p->count; i++)
+         Traits::destroy(alloc, p->slot(i));
+      p->count = 0;
+      deleteNode(p);
+   }
+   numElements = 0;
+}
+
+/**********************************************
+ * UNROLLED LIST :: NEW NODE AFTER
+ * Link an empty node after pPrev, or at the
+ * front when pPrev is nullptr
+ **********************************************/
+template <typename T, size_t K, typename A>
+typename unrolled_list <T, K, A> :: Node *
+unrolled_list <T, K, A> :: newNodeAfter(Node * pPrev)
+{
+   Node * pNew = NodeTraits::allocate(nodeAlloc, 1);
+   NodeTraits::construct(nodeAlloc, pNew);
+
+   pNew->pPrev = pPrev;
+   pNew->pNext = pPrev ? pPrev->pNext : pHead;
+   if (pNew->pNext)
+      pNew->pNext->pPrev = pNew;
+   else
+      pTail = pNew;
+   if (pPrev)
+      pPrev->pNext = pNew;
+   else
+      pHead = pNew;
+   return pNew;
+}
+
+/**********************************************
+ * UNROLLED LIST :: DELETE NODE
+ * Unlink and free a node whose elements are gone
+ **********************************************/
+template <typename T, size_t K, typename A>
+void unrolled_list <T, K, A> :: deleteNode(Node * p)
+{
+   assert(p->count == 0);
+   if (p->pPrev)
+      p->pPrev->pNext = p->pNext;
+   else
+      pHead = p->pNext;
+   if (p->pNext)
+      p->pNext->pPrev = p->pPrev;
+   else
+      pTail = p->pPrev;
+
+   NodeTraits::destroy(nodeAlloc, p);
+   NodeTraits::deallocate(nodeAlloc, p, 1);
+}
+
+/**********************************************
+ * UNROLLED LIST :: MERGE NEXT
+ * Move every element of the node after p onto
+ * the end of p and free that node. They must fit.
+ **********************************************/
+template <typename T, size_t K, typename A>
+void unrolled_list <T, K, A> :: mergeNext(Node * p)
+{
+   Node * pNext = p->pNext;
+   assert(pNext != nullptr && p->count + pNext->count <= K);
+   for (size_t j = 0; j < pNext->count; j++)
+      relocate(p->slot(p->count + j), pNext->slot(j));
+   p->count += pNext->count;
+   pNext->count = 0;
+   deleteNode(pNext);
+}
+
+/**********************************************
+ * UNROLLED LIST :: RELOCATE
+ * Move an element to an empty slot, leaving its
+ * old slot empty
+ **********************************************/
+template <typename T, size_t K, typename A>
+void unrolled_list <T, K, A> :: relocate(T * pDest, T * pSrc)
+{
+   Traits::construct(alloc, pDest, std::move(*pSrc));
+   Traits::destroy(alloc, pSrc);
+}
+
+/**********************************************
+ * UNROLLED LIST :: INSERT AT
+ * Open a gap at slot i of a node with room to
+ * spare and build the new element there
+ **********************************************/
+template <typename T, size_t K, typename A>
+template <class U>
+void unrolled_list <T, K, A> :: insertAt(Node * p, size_t i, U && u)
+{
+   assert(p->count < K && i <= p->count);
+   for (size_t j = p->count; j > i; j--)
+      relocate(p->slot(j), p->slot(j - 1));
+   Traits::construct(alloc, p->slot(i), std::forward<U>(u));
+   p->count++;
+   numElements++;
+}
+
+/**********************************************
+ * SWAP
+ * Swap the contents of two unrolled lists
+ **********************************************/
+template <typename T, size_t K, typename A>
+inline void swap(unrolled_list <T, K, A> & lhs, unrolled_list <T, K, A> & rhs)
+{
+   lhs.swap(rhs);
+}
+
+}; // namespace custom
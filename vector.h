@@ -169,6 +169,7 @@ public:
    iterator(size_t index, vector<T>& v) { p = v.data + index; }
    iterator& operator = (const iterator& rhs)
    {
+      p = rhs.p;
       return *this;
    }
 
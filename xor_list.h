@@ -0,0 +1,508 @@
+/***********************************************************************
+ * Header:
+ *    XOR LIST
+ * Summary:
+ *    A doubly linked list that keeps one link per node instead of two
+ *      __      __     _______        __
+ *     /  |    /  |   |  _____|   _  / /
+ *     `| |    `| |   | |____    (_)/ /
+ *      | |     | |   '_.____''.   / / _
+ *     _| |_   _| |_  | \____) |  / / (_)
+ *    |_____| |_____|  \______.' /_/
+ *
+ *
+ *    This will contain the class definition of:
+ *        xor_list            : A list with XOR-linked nodes
+ *        xor_list::iterator  : An iterator through the list
+ * Author
+ *    Tyler and Braedon
+ ************************************************************************/
+
+#pragma once
+
+#include <cassert>
+#include <cstdint>     // for uintptr_t
+#include <initializer_list>
+#include <memory>      // for std::allocator
+#include <new>         // std::bad_alloc
+#include <utility>     // for std::swap
+
+class TestXorList;    // forward declaration for unit tests
+
+namespace custom
+{
+
+/**************************************************
+ * XOR LIST
+ * The same interface as list, but each node stores
+ * pNext XOR pPrev in a single word. Knowing either
+ * neighbour recovers the other, so an iterator carries
+ * the node before it as well as its own node, and
+ * walks both ways. With a small T this halves what
+ * the links cost per element. Reversing the whole
+ * list is O(1): swap the head and the tail.
+ *
+ * Because an iterator remembers its neighbour,
+ * insert and erase invalidate iterators to the
+ * nodes on either side, not only the one erased.
+ **************************************************/
+template <typename T, typename A = std::allocator<T>>
+class xor_list
+{
+   friend class ::TestXorList; // give unit tests access to the privates
+
+   class Node;
+   using NodeAlloc  = typename std::allocator_traits<A>::template rebind_alloc<Node>;
+   using NodeTraits = std::allocator_traits<NodeAlloc>;
+
+public:
+
+   //
+   // Construct
+   //
+
+   xor_list(const A & a = A()) :
+      nodeAlloc(a), numElements(0), pHead(nullptr), pTail(nullptr)
+   {
+   }
+   xor_list(const xor_list & rhs) : xor_list()
+   {
+      *this = rhs;
+   }
+   xor_list(xor_list && rhs) : xor_list()
+   {
+      swap(rhs);
+   }
+   xor_list(size_t num, const T & t, const A & a = A()) : xor_list(a)
+   {
+      for (size_t i = 0; i < num; i++)
+         push_back(t);
+   }
+   xor_list(size_t num, const A & a = A()) : xor_list(a)
+   {
+      for (size_t i = 0; i < num; i++)
+         push_back(T());
+   }
+   xor_list(const std::initializer_list<T> & il, const A & a = A()) : xor_list(a)
+   {
+      *this = il;
+   }
+   template <class Iterator>
+   xor_list(Iterator first, Iterator last, const A & a = A()) : xor_list(a)
+   {
+      while (first != last)
+         push_back(*(first++));
+   }
+   ~xor_list()
+   {
+      clear();
+   }
+
+   //
+   // Assign
+   //
+
+   xor_list & operator = (const xor_list & rhs);
+   xor_list & operator = (xor_list && rhs)
+   {
+      clear();
+      swap(rhs);
+      return *this;
+   }
+   xor_list & operator = (const std::initializer_list<T> & il);
+   void swap(xor_list & rhs)
+   {
+      std::swap(numElements, rhs.numElements);
+      std::swap(pHead, rhs.pHead);
+      std::swap(pTail, rhs.pTail);
+   }
+
+   //
+   // Iterator
+   //
+
+   class iterator;
+   iterator begin()  { return iterator(nullptr, pHead); }
+   iterator rbegin() { return iterator(pTail ? pTail->other(nullptr) : nullptr, pTail); }
+   iterator end()    { return iterator(pTail, nullptr); }
+
+   //
+   // Access
+   //
+
+   T & front();
+   T & back();
+
+   //
+   // Insert
+   //
+
+   void push_front(const T &  data) { insert(begin(), data);            }
+   void push_front(      T && data) { insert(begin(), std::move(data)); }
+   void push_back (const T &  data) { insert(end(),   data);            }
+   void push_back (      T && data) { insert(end(),   std::move(data)); }
+   iterator insert(iterator it, const T &  data) { return link(it, newNode(data));            }
+   iterator insert(iterator it,       T && data) { return link(it, newNode(std::move(data))); }
+
+   //
+   // Remove
+   //
+
+   void pop_back()  { if (pTail) erase(rbegin()); }
+   void pop_front() { if (pHead) erase(begin());  }
+   void clear();
+   iterator erase(const iterator & it);
+
+   //
+   // Splice and reverse
+   //
+
+   void splice(iterator pos, xor_list & rhs);
+   void splice_front(xor_list & rhs) { splice(begin(), rhs); }
+   void splice_back (xor_list & rhs) { splice(end(),   rhs); }
+   void reverse() { std::swap(pHead, pTail); }
+
+   //
+   // Status
+   //
+
+   bool empty()  const { return numElements == 0; }
+   size_t size() const { return numElements;      }
+
+private:
+
+   template <class U>
+   Node * newNode(U && u);
+   void deleteNode(Node * p);
+   iterator link(iterator it, Node * pNew);
+
+   NodeAlloc nodeAlloc;   // allocates the nodes
+   size_t numElements;    // though we could count, it is faster to keep a variable
+   Node * pHead;          // pointer to the beginning of the list
+   Node * pTail;          // pointer to the ending of the list
+};
+
+/*************************************************
+ * XOR LIST NODE
+ * One word holds both neighbours: given one, other()
+ * gives back the second. A missing neighbour counts
+ * as nullptr, so an end node's link is just the
+ * address of the one neighbour it has.
+ *************************************************/
+template <typename T, typename A>
+class xor_list <T, A> :: Node
+{
+public:
+   template <class U>
+   Node(U && u) : data(std::forward<U>(u)), both(0)
+   {
+   }
+
+   Node * other(const Node * p) const
+   {
+      return reinterpret_cast<Node *>(both ^ reinterpret_cast<uintptr_t>(p));
+   }
+
+   // swap neighbour pOld for pNew, leaving the other neighbour alone
+   void relink(const Node * pOld, const Node * pNew)
+   {
+      both ^= reinterpret_cast<uintptr_t>(pOld) ^ reinterpret_cast<uintptr_t>(pNew);
+   }
+
+   T data;             // user data
+   uintptr_t both;     // address of next XOR address of previous
+};
+
+/*************************************************
+ * XOR LIST ITERATOR
+ * A node and the node before it. The pair is needed
+ * to step either way. end() is (pTail, nullptr) so
+ * that --end() reaches the last element.
+ ************************************************/
+template <typename T, typename A>
+class xor_list <T, A> :: iterator
+{
+   friend class ::TestXorList; // give unit tests access to the privates
+   friend class xor_list <T, A>;
+public:
+   iterator() : pPrev(nullptr), p(nullptr)
+   {
+   }
+   iterator(Node * pPrev, Node * p) : pPrev(pPrev), p(p)
+   {
+   }
+
+   // equals, not equals operator
+   bool operator == (const iterator & rhs) const { return p == rhs.p; }
+   bool operator != (const iterator & rhs) const { return p != rhs.p; }
+
+   // dereference operator
+   T & operator *  () { return p->data;  }
+   T * operator -> () { return &p->data; }
+
+   // prefix and postfix increment
+   iterator & operator ++ ()
+   {
+      Node * pNext = p->other(pPrev);
+      pPrev = p;
+      p = pNext;
+      return *this;
+   }
+   iterator operator ++ (int postfix)
+   {
+      iterator temp(*this);
+      ++(*this);
+      return temp;
+   }
+
+   // prefix and postfix decrement
+   iterator & operator -- ()
+   {
+      // Before the front is the end, as with list
+      if (pPrev == nullptr)
+      {
+         p = nullptr;
+         return *this;
+      }
+      Node * pPrevPrev = pPrev->other(p);
+      p = pPrev;
+      pPrev = pPrevPrev;
+      return *this;
+   }
+   iterator operator -- (int postfix)
+   {
+      iterator temp(*this);
+      --(*this);
+      return temp;
+   }
+
+private:
+   Node * pPrev;   // the node before p, or nullptr at the front
+   Node * p;       // the current node, or nullptr at the end
+};
+
+/**********************************************
+ * XOR LIST :: assignment operator
+ * Copy one list onto another, reusing the nodes
+ * we already have
+ *     COST   : O(n) with respect to the number of nodes
+ *********************************************/
+template <typename T, typename A>
+xor_list <T, A> & xor_list <T, A> :: operator = (const xor_list <T, A> & rhs)
+{
+   if (this == &rhs)
+      return *this;
+
+   iterator itLHS = begin();
+   const Node * pPrev = nullptr;
+   for (const Node * p = rhs.pHead; p; )
+   {
+      if (itLHS != end())
+         *(itLHS++) = p->data;
+      else
+         push_back(p->data);
+
+      const Node * pNext = p->other(pPrev);
+      pPrev = p;
+      p = pNext;
+   }
+
+   // Remove extra nodes
+   while (itLHS != end())
+      itLHS = erase(itLHS);
+   return *this;
+}
+
+/**********************************************
+ * XOR LIST :: assignment operator
+ * Copy an initializer list onto this one
+ *     COST   : O(n) with respect to the number of nodes
+ *********************************************/
+template <typename T, typename A>
+xor_list <T, A> & xor_list <T, A> :: operator = (const std::initializer_list<T> & il)
+{
+   iterator itLHS = begin();
+   for (const T & t : il)
+   {
+      if (itLHS != end())
+         *(itLHS++) = t;
+      else
+         push_back(t);
+   }
+
+   // Remove extra nodes
+   while (itLHS != end())
+      itLHS = erase(itLHS);
+   return *this;
+}
+
+/*********************************************
+ * XOR LIST :: FRONT and BACK
+ * The first and last elements in the list
+ *     COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+T & xor_list <T, A> :: front()
+{
+   if (pHead)
+      return pHead->data;
+   throw("ERROR: unable to access data from an empty list");
+}
+template <typename T, typename A>
+T & xor_list <T, A> :: back()
+{
+   if (pTail)
+      return pTail->data;
+   throw("ERROR: unable to access data from an empty list");
+}
+
+/**********************************************
+ * XOR LIST :: CLEAR
+ * Remove all the items currently in the list
+ *     COST   : O(n) with respect to the number of nodes
+ *********************************************/
+template <typename T, typename A>
+void xor_list <T, A> :: clear()
+{
+   Node * pPrev = nullptr;
+   Node * p = pHead;
+   while (p)
+   {
+      Node * pNext = p->other(pPrev);
+      pPrev = p;
+      deleteNode(p);
+      p = pNext;
+   }
+   pHead = pTail = nullptr;
+   numElements = 0;
+}
+
+/******************************************
+ * XOR LIST :: ERASE
+ * Remove the item at it. The neighbours' links
+ * each lose it and gain each other.
+ *     OUTPUT : iterator to the item after the one removed
+ *     COST   : O(1)
+ ******************************************/
+template <typename T, typename A>
+typename xor_list <T, A> :: iterator xor_list <T, A> :: erase(const iterator & it)
+{
+   Node * p = it.p;
+   if (p == nullptr)
+      return end();
+   Node * pPrev = it.pPrev;
+   Node * pNext = p->other(pPrev);
+
+   if (pPrev)
+      pPrev->relink(p, pNext);
+   else
+      pHead = pNext;
+   if (pNext)
+      pNext->relink(p, pPrev);
+   else
+      pTail = pPrev;
+
+   deleteNode(p);
+   numElements--;
+   return iterator(pPrev, pNext);
+}
+
+/******************************************
+ * XOR LIST :: SPLICE
+ * Move every node of rhs in front of pos. Only
+ * the four nodes at the seams change.
+ *     COST   : O(1)
+ ******************************************/
+template <typename T, typename A>
+void xor_list <T, A> :: splice(iterator pos, xor_list <T, A> & rhs)
+{
+   if (this == &rhs || rhs.empty())
+      return;
+
+   Node * pPrev = pos.pPrev;
+   Node * pNext = pos.p;
+
+   // The chain's ends pick up their new neighbours
+   rhs.pHead->relink(nullptr, pPrev);
+   rhs.pTail->relink(nullptr, pNext);
+
+   // and the seam nodes swap each other for the chain's ends
+   if (pPrev)
+      pPrev->relink(pNext, rhs.pHead);
+   else
+      pHead = rhs.pHead;
+   if (pNext)
+      pNext->relink(pPrev, rhs.pTail);
+   else
+      pTail = rhs.pTail;
+
+   numElements += rhs.numElements;
+   rhs.pHead = rhs.pTail = nullptr;
+   rhs.numElements = 0;
+}
+
+/******************************************
+ * XOR LIST :: LINK
+ * Put a new node in front of it
+ *     OUTPUT : iterator to the new node
+ *     COST   : O(1)
+ ******************************************/
+template <typename T, typename A>
+typename xor_list <T, A> :: iterator xor_list <T, A> :: link(iterator it, Node * pNew)
+{
+   Node * pPrev = it.pPrev;
+   Node * pNext = it.p;
+
+   pNew->both = reinterpret_cast<uintptr_t>(pPrev) ^ reinterpret_cast<uintptr_t>(pNext);
+   if (pPrev)
+      pPrev->relink(pNext, pNew);
+   else
+      pHead = pNew;
+   if (pNext)
+      pNext->relink(pPrev, pNew);
+   else
+      pTail = pNew;
+
+   numElements++;
+   return iterator(pPrev, pNew);
+}
+
+/******************************************
+ * XOR LIST :: NEW NODE and DELETE NODE
+ * Build and tear down a node with the allocator
+ ******************************************/
+template <typename T, typename A>
+template <class U>
+typename xor_list <T, A> :: Node * xor_list <T, A> :: newNode(U && u)
+{
+   Node * p = NodeTraits::allocate(nodeAlloc, 1);
+   try
+   {
+      NodeTraits::construct(nodeAlloc, p, std::forward<U>(u));
+   }
+   catch (...)
+   {
+      NodeTraits::deallocate(nodeAlloc, p, 1);
+      throw;
+   }
+   return p;
+}
+template <typename T, typename A>
+void xor_list <T, A> :: deleteNode(Node * p)
+{
+   NodeTraits::destroy(nodeAlloc, p);
+   NodeTraits::deallocate(nodeAlloc, p, 1);
+}
+
+/**********************************************
+ * SWAP
+ * Swap one list with another
+ *     COST   : O(1)
+ *********************************************/
+template <typename T, typename A>
+void swap(xor_list <T, A> & lhs, xor_list <T, A> & rhs)
+{
+   lhs.swap(rhs);
+}
+
+}; // namespace custom